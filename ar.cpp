@@ -1460,6 +1460,7 @@ static void action_replay_setbanks (void)
 			chipmem_bank.lput = chipmem_lput_actionreplay1;
 			break;
 		}
+		chipmem_handlers_changed ();
 	}
 }
 
@@ -1468,6 +1469,7 @@ static void action_replay_unsetbanks (void)
 	chipmem_bank.bput = chipmem_bput;
 	chipmem_bank.wput = chipmem_wput;
 	chipmem_bank.lput = chipmem_lput;
+	chipmem_handlers_changed ();
 }
 
 /* param to allow us to unload the cart. Currently we know it is safe if we are doing a reset to unload it.*/
@@ -1087,6 +1087,27 @@ extern z_off_t ZEXPORT unztell (unzFile file)
 }
 
 
+/*
+  Give the position of the (possibly compressed) data of the current file
+  in the zipfile. Only valid before the first unzReadCurrentFile.
+*/
+extern uLong ZEXPORT unzGetCurrentFileZStreamPos (unzFile file)
+{
+	unz_s* s;
+	file_in_zip_read_info_s* pfile_in_zip_read_info;
+	if (file==NULL)
+		return 0;
+	s=(unz_s*)file;
+    pfile_in_zip_read_info=s->pfile_in_zip_read;
+
+	if (pfile_in_zip_read_info==NULL)
+		return 0;
+
+	return pfile_in_zip_read_info->pos_in_zipfile +
+		pfile_in_zip_read_info->byte_before_the_zipfile;
+}
+
+
 /*
   return 1 if the end of file was reached, 0 elsewhere
 */
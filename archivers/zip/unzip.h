@@ -262,6 +262,12 @@ extern z_off_t ZEXPORT unztell OF((unzFile file));
   Give the current position in uncompressed data
 */
 
+extern uLong ZEXPORT unzGetCurrentFileZStreamPos OF((unzFile file));
+/*
+  Give the position of the current file data in the zipfile, 0 on error.
+  Only valid before the first unzReadCurrentFile.
+*/
+
 extern int ZEXPORT unzeof OF((unzFile file));
 /*
   return 1 if the end of file was reached, 0 elsewhere
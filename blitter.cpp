@@ -67,7 +67,7 @@ static int blitter_slowdowndebug;
 
 struct bltinfo blt_info;
 
-static uae_u8 blit_filltable[256][4][2];
+uae_u8 blit_filltable[256][4][2];
 uae_u32 blit_masktable[BLITTER_MAX_WORDS];
 enum blitter_states bltstate;
 
@@ -470,6 +470,11 @@ static void blitter_dofast (void)
 #if SPEEDUP
 	if (blitfunc_dofast[mt] && !blitfill) {
 		(*blitfunc_dofast[mt])(bltadatptr, bltbdatptr, bltcdatptr, bltddatptr, &blt_info);
+	} else if (blitfunc_dofast_fill[mt] && blitfill) {
+		blt_info.blitfc = !!(bltcon1 & 0x4);
+		blt_info.blitife = blitife;
+		(*blitfunc_dofast_fill[mt])(bltadatptr, bltbdatptr, bltcdatptr, bltddatptr, &blt_info);
+		blitfc = blt_info.blitfc;
 	} else
 #endif
 	{
@@ -569,6 +574,11 @@ static void blitter_dofast_desc (void)
 #if SPEEDUP
 	if (blitfunc_dofast_desc[mt] && !blitfill) {
 		(*blitfunc_dofast_desc[mt])(bltadatptr, bltbdatptr, bltcdatptr, bltddatptr, &blt_info);
+	} else if (blitfunc_dofast_desc_fill[mt] && blitfill) {
+		blt_info.blitfc = !!(bltcon1 & 0x4);
+		blt_info.blitife = blitife;
+		(*blitfunc_dofast_desc_fill[mt])(bltadatptr, bltbdatptr, bltcdatptr, bltddatptr, &blt_info);
+		blitfc = blt_info.blitfc;
 	} else
 #endif
 	{
@@ -1201,6 +1201,7 @@ void cfgfile_save_options (struct zfile *f, struct uae_prefs *p, int type)
 	cfgfile_write_str (f, _T("comp_trustnaddr"), compmode[p->comptrustnaddr]);
 	cfgfile_write_bool (f, _T("comp_nf"), p->compnf);
 	cfgfile_write_bool (f, _T("comp_constjump"), p->comp_constjump);
+	cfgfile_write_bool (f, _T("comp_keepblocks"), p->comp_keepblocks);
 	cfgfile_write_bool (f, _T("comp_oldsegv"), p->comp_oldsegv);
 	cfgfile_write_str (f, _T("comp_flushmode"), flushmode[p->comp_hardflush]);
 	cfgfile_write_bool (f, _T("compfpu"), p->compfpu);
@@ -2045,6 +2046,326 @@ static void set_chipset_mask (struct uae_prefs *p, int val)
 		: CSMASK_AGA | CSMASK_ECS_DENISE | CSMASK_ECS_AGNUS);
 }
 
+/* Options that map straight onto one uae_prefs field. They are found
+ * through a hash index instead of walking long cfgfile_yesno/intval
+ * chains for every line of every config file. The usual cfgfile_xxx
+ * helpers still do the value conversion and error reporting. */
+
+enum { CFGTYPE_YESNO, CFGTYPE_INT, CFGTYPE_DOUBLE, CFGTYPE_FLOAT, CFGTYPE_STRVAL, CFGTYPE_STRING };
+
+struct cfgopt
+{
+	const TCHAR *name;
+	int type;
+	int offset, size;
+	int scale;
+	const TCHAR **table;
+};
+
+#define CFGOPT_FIELD(f) (int)offsetof (struct uae_prefs, f), (int)sizeof (((struct uae_prefs*)0)->f)
+#define CFGOPT_YESNO(n, f) { n, CFGTYPE_YESNO, CFGOPT_FIELD(f), 0, NULL }
+#define CFGOPT_INT(n, f, scale) { n, CFGTYPE_INT, CFGOPT_FIELD(f), scale, NULL }
+#define CFGOPT_DOUBLE(n, f) { n, CFGTYPE_DOUBLE, CFGOPT_FIELD(f), 0, NULL }
+#define CFGOPT_FLOAT(n, f) { n, CFGTYPE_FLOAT, CFGOPT_FIELD(f), 0, NULL }
+#define CFGOPT_STRVAL(n, f, table) { n, CFGTYPE_STRVAL, CFGOPT_FIELD(f), 0, table }
+#define CFGOPT_STRING(n, f) { n, CFGTYPE_STRING, CFGOPT_FIELD(f), 0, NULL }
+
+static const struct cfgopt cfgopts_hardware[] = {
+	CFGOPT_YESNO(_T("immediate_blits"), immediate_blits),
+	CFGOPT_YESNO(_T("fpu_no_unimplemented"), fpu_no_unimplemented),
+	CFGOPT_YESNO(_T("cpu_no_unimplemented"), int_no_unimplemented),
+	CFGOPT_YESNO(_T("cd32cd"), cs_cd32cd),
+	CFGOPT_YESNO(_T("cd32c2p"), cs_cd32c2p),
+	CFGOPT_YESNO(_T("cd32nvram"), cs_cd32nvram),
+	CFGOPT_YESNO(_T("cd32fmv"), cs_cd32fmv),
+	CFGOPT_YESNO(_T("cdtvcd"), cs_cdtvcd),
+	CFGOPT_YESNO(_T("cdtv-cr"), cs_cdtvcr),
+	CFGOPT_YESNO(_T("cdtvram"), cs_cdtvram),
+	CFGOPT_YESNO(_T("a1000ram"), cs_a1000ram),
+	CFGOPT_YESNO(_T("pcmcia"), cs_pcmcia),
+	CFGOPT_YESNO(_T("scsi_cdtv"), cs_cdtvscsi),
+	CFGOPT_YESNO(_T("cia_overlay"), cs_ciaoverlay),
+	CFGOPT_YESNO(_T("bogomem_fast"), cs_slowmemisfast),
+	CFGOPT_YESNO(_T("ksmirror_e0"), cs_ksmirror_e0),
+	CFGOPT_YESNO(_T("ksmirror_a8"), cs_ksmirror_a8),
+	CFGOPT_YESNO(_T("resetwarning"), cs_resetwarning),
+	CFGOPT_YESNO(_T("cia_todbug"), cs_ciatodbug),
+	CFGOPT_YESNO(_T("denise_noehb"), cs_denisenoehb),
+	CFGOPT_YESNO(_T("ics_agnus"), cs_dipagnus),
+	CFGOPT_YESNO(_T("z3_autoconfig"), cs_z3autoconfig),
+	CFGOPT_YESNO(_T("1mchipjumper"), cs_1mchipjumper),
+	CFGOPT_YESNO(_T("agnus_bltbusybug"), cs_agnusbltbusybug),
+	CFGOPT_YESNO(_T("fastmem_autoconfig"), fastmem_autoconfig),
+	CFGOPT_YESNO(_T("gfxcard_hardware_vblank"), rtg_hardwareinterrupt),
+	CFGOPT_YESNO(_T("gfxcard_hardware_sprite"), rtg_hardwaresprite),
+	CFGOPT_YESNO(_T("synchronize_clock"), tod_hack),
+
+	CFGOPT_YESNO(_T("kickshifter"), kickshifter),
+	CFGOPT_YESNO(_T("ks_write_enabled"), rom_readwrite),
+	CFGOPT_YESNO(_T("ntsc"), ntscmode),
+	CFGOPT_YESNO(_T("sana2"), sana2),
+	CFGOPT_YESNO(_T("genlock"), genlock),
+	CFGOPT_YESNO(_T("cpu_compatible"), cpu_compatible),
+	CFGOPT_YESNO(_T("cpu_24bit_addressing"), address_space_24),
+	CFGOPT_YESNO(_T("cpu_reset_pause"), reset_delay),
+	CFGOPT_YESNO(_T("parallel_on_demand"), parallel_demand),
+	CFGOPT_YESNO(_T("parallel_postscript_emulation"), parallel_postscript_emulation),
+	CFGOPT_YESNO(_T("parallel_postscript_detection"), parallel_postscript_detection),
+	CFGOPT_YESNO(_T("serial_on_demand"), serial_demand),
+	CFGOPT_YESNO(_T("serial_hardware_ctsrts"), serial_hwctsrts),
+	CFGOPT_YESNO(_T("serial_direct"), serial_direct),
+	CFGOPT_YESNO(_T("fpu_strict"), fpu_strict),
+	CFGOPT_YESNO(_T("fpu_softfloat"), fpu_softfloat),
+	CFGOPT_YESNO(_T("comp_nf"), compnf),
+	CFGOPT_YESNO(_T("comp_constjump"), comp_constjump),
+	CFGOPT_YESNO(_T("comp_keepblocks"), comp_keepblocks),
+	CFGOPT_YESNO(_T("comp_oldsegv"), comp_oldsegv),
+	CFGOPT_YESNO(_T("compfpu"), compfpu),
+	CFGOPT_YESNO(_T("comp_midopt"), comp_midopt),
+	CFGOPT_YESNO(_T("comp_lowopt"), comp_lowopt),
+	CFGOPT_YESNO(_T("rtg_nocustom"), picasso96_nocustom),
+	CFGOPT_YESNO(_T("floppy_write_protect"), floppy_read_only),
+	CFGOPT_YESNO(_T("uae_hide_autoconfig"), uae_hide_autoconfig),
+	CFGOPT_YESNO(_T("toccata"), sound_toccata),
+	CFGOPT_YESNO(_T("toccata_mixer"), sound_toccata_mixer),
+	CFGOPT_YESNO(_T("uaeserial"), uaeserial),
+
+	CFGOPT_INT(_T("cachesize"), cachesize, 1),
+	CFGOPT_INT(_T("cd32nvram_size"), cs_cd32nvram_size, 1024),
+	CFGOPT_INT(_T("chipset_hacks"), cs_hacks, 1),
+	CFGOPT_INT(_T("serial_stopbits"), serial_stopbits, 1),
+	CFGOPT_INT(_T("cpu060_revision"), cpu060_revision, 1),
+	CFGOPT_INT(_T("fpu_revision"), fpu_revision, 1),
+	CFGOPT_INT(_T("cdtvramcard"), cs_cdtvcard, 1),
+	CFGOPT_INT(_T("fatgary"), cs_fatgaryrev, 1),
+	CFGOPT_INT(_T("ramsey"), cs_ramseyrev, 1),
+	CFGOPT_DOUBLE(_T("chipset_refreshrate"), chipset_refreshrate),
+	CFGOPT_INT(_T("cpuboardmem1_size"), cpuboardmem1_size, 0x100000),
+	CFGOPT_INT(_T("cpuboardmem2_size"), cpuboardmem2_size, 0x100000),
+	CFGOPT_INT(_T("fastmem_size"), fastmem_size, 0x100000),
+	CFGOPT_INT(_T("fastmem_size_k"), fastmem_size, 1024),
+	CFGOPT_INT(_T("fastmem2_size"), fastmem2_size, 0x100000),
+	CFGOPT_INT(_T("fastmem2_size_k"), fastmem2_size, 1024),
+	CFGOPT_INT(_T("mem25bit_size"), mem25bit_size, 0x100000),
+	CFGOPT_INT(_T("a3000mem_size"), mbresmem_low_size, 0x100000),
+	CFGOPT_INT(_T("mbresmem_size"), mbresmem_high_size, 0x100000),
+	CFGOPT_INT(_T("z3mem_size"), z3fastmem_size, 0x100000),
+	CFGOPT_INT(_T("z3mem2_size"), z3fastmem2_size, 0x100000),
+	CFGOPT_INT(_T("megachipmem_size"), z3chipmem_size, 0x100000),
+	CFGOPT_INT(_T("z3mem_start"), z3autoconfig_start, 1),
+	CFGOPT_INT(_T("bogomem_size"), bogomem_size, 0x40000),
+	CFGOPT_INT(_T("gfxcard_size"), rtgmem_size, 0x100000),
+	CFGOPT_STRVAL(_T("gfxcard_type"), rtgmem_type, rtgtype),
+	CFGOPT_INT(_T("rtg_modes"), picasso96_modeflags, 1),
+	CFGOPT_INT(_T("floppy_speed"), floppy_speed, 1),
+	CFGOPT_INT(_T("cd_speed"), cd_speed, 1),
+	CFGOPT_INT(_T("floppy_write_length"), floppy_write_length, 1),
+	CFGOPT_INT(_T("floppy_random_bits_min"), floppy_random_bits_min, 1),
+	CFGOPT_INT(_T("floppy_random_bits_max"), floppy_random_bits_max, 1),
+	CFGOPT_INT(_T("nr_floppies"), nr_floppies, 1),
+	CFGOPT_INT(_T("floppy0type"), floppyslots[0].dfxtype, 1),
+	CFGOPT_INT(_T("floppy1type"), floppyslots[1].dfxtype, 1),
+	CFGOPT_INT(_T("floppy2type"), floppyslots[2].dfxtype, 1),
+	CFGOPT_INT(_T("floppy3type"), floppyslots[3].dfxtype, 1),
+	CFGOPT_INT(_T("maprom"), maprom, 1),
+	CFGOPT_INT(_T("parallel_autoflush"), parallel_autoflush_time, 1),
+	CFGOPT_INT(_T("uae_hide"), uae_hide, 1),
+	CFGOPT_INT(_T("cpu_frequency"), cpu_frequency, 1),
+	CFGOPT_INT(_T("kickstart_ext_rom_file2addr"), romextfile2addr, 1),
+	CFGOPT_INT(_T("catweasel"), catweasel, 1),
+
+	CFGOPT_STRVAL(_T("comp_trustbyte"), comptrustbyte, compmode),
+	CFGOPT_STRVAL(_T("rtc"), cs_rtc, rtctype),
+	CFGOPT_STRVAL(_T("ciaatod"), cs_ciaatod, ciaatodmode),
+	CFGOPT_STRVAL(_T("ide"), cs_ide, idemode),
+	CFGOPT_STRVAL(_T("scsi"), scsi, scsimode),
+	CFGOPT_STRVAL(_T("comp_trustword"), comptrustword, compmode),
+	CFGOPT_STRVAL(_T("comp_trustlong"), comptrustlong, compmode),
+	CFGOPT_STRVAL(_T("comp_trustnaddr"), comptrustnaddr, compmode),
+	CFGOPT_STRVAL(_T("collision_level"), collision_level, collmode),
+	CFGOPT_STRVAL(_T("parallel_matrix_emulation"), parallel_matrix_emulation, epsonprinter),
+	CFGOPT_STRVAL(_T("monitoremu"), monitoremu, specialmonitors),
+	CFGOPT_STRVAL(_T("waiting_blits"), waiting_blits, waitblits),
+	CFGOPT_STRVAL(_T("floppy_auto_extended_adf"), floppy_auto_ext2, autoext2),
+	CFGOPT_STRVAL(_T("z3mapping"), z3_mapping_mode, z3mapping),
+	CFGOPT_STRVAL(_T("scsidev_mode"), uaescsidevmode, uaescsidevmodes),
+	CFGOPT_STRVAL(_T("boot_rom_uae"), boot_rom, uaebootrom),
+	CFGOPT_STRVAL(_T("comp_flushmode"), comp_hardflush, flushmode),
+};
+
+static const struct cfgopt cfgopts_host[] = {
+	CFGOPT_INT(_T("sound_frequency"), sound_freq, 1),
+	CFGOPT_INT(_T("sound_max_buff"), sound_maxbsiz, 1),
+	CFGOPT_INT(_T("state_replay_rate"), statecapturerate, 1),
+	CFGOPT_INT(_T("state_replay_buffers"), statecapturebuffersize, 1),
+	CFGOPT_YESNO(_T("state_replay_autoplay"), inprec_autoplay),
+	CFGOPT_INT(_T("sound_volume"), sound_volume_master, 1),
+	CFGOPT_INT(_T("sound_volume_paula"), sound_volume_paula, 1),
+	CFGOPT_INT(_T("sound_volume_cd"), sound_volume_cd, 1),
+	CFGOPT_INT(_T("sound_volume_ahi"), sound_volume_board, 1),
+	CFGOPT_INT(_T("sound_stereo_separation"), sound_stereo_separation, 1),
+	CFGOPT_INT(_T("sound_stereo_mixing_delay"), sound_mixed_stereo_delay, 1),
+	CFGOPT_INT(_T("sampler_frequency"), sampler_freq, 1),
+	CFGOPT_INT(_T("sampler_buffer"), sampler_buffer, 1),
+
+	CFGOPT_INT(_T("gfx_framerate"), gfx_framerate, 1),
+	CFGOPT_INT(_T("gfx_top_windowed"), gfx_size_win.x, 1),
+	CFGOPT_INT(_T("gfx_left_windowed"), gfx_size_win.y, 1),
+	CFGOPT_INT(_T("gfx_refreshrate"), gfx_apmode[APMODE_NATIVE].gfx_refreshrate, 1),
+	CFGOPT_INT(_T("gfx_refreshrate_rtg"), gfx_apmode[APMODE_RTG].gfx_refreshrate, 1),
+	CFGOPT_INT(_T("gfx_autoresolution_delay"), gfx_autoresolution_delay, 1),
+	CFGOPT_INT(_T("gfx_backbuffers"), gfx_apmode[APMODE_NATIVE].gfx_backbuffers, 1),
+	CFGOPT_INT(_T("gfx_backbuffers_rtg"), gfx_apmode[APMODE_RTG].gfx_backbuffers, 1),
+	CFGOPT_YESNO(_T("gfx_interlace"), gfx_apmode[APMODE_NATIVE].gfx_interlaced),
+	CFGOPT_YESNO(_T("gfx_interlace_rtg"), gfx_apmode[APMODE_RTG].gfx_interlaced),
+
+	CFGOPT_INT(_T("gfx_center_horizontal_position"), gfx_xcenter_pos, 1),
+	CFGOPT_INT(_T("gfx_center_vertical_position"), gfx_ycenter_pos, 1),
+	CFGOPT_INT(_T("gfx_center_horizontal_size"), gfx_xcenter_size, 1),
+	CFGOPT_INT(_T("gfx_center_vertical_size"), gfx_ycenter_size, 1),
+
+	CFGOPT_INT(_T("filesys_max_size"), filesys_limit, 1),
+	CFGOPT_INT(_T("benchmark_frames"), benchmark_frames, 1),
+	CFGOPT_INT(_T("filesys_max_name_length"), filesys_max_name, 1),
+	CFGOPT_INT(_T("filesys_max_file_size"), filesys_max_file_size, 1),
+	CFGOPT_YESNO(_T("filesys_inject_icons"), filesys_inject_icons),
+	CFGOPT_STRING(_T("filesys_inject_icons_drawer"), filesys_inject_icons_drawer),
+	CFGOPT_STRING(_T("filesys_inject_icons_project"), filesys_inject_icons_project),
+	CFGOPT_STRING(_T("filesys_inject_icons_tool"), filesys_inject_icons_tool),
+
+	CFGOPT_INT(_T("gfx_luminance"), gfx_luminance, 1),
+	CFGOPT_INT(_T("gfx_contrast"), gfx_contrast, 1),
+	CFGOPT_INT(_T("gfx_gamma"), gfx_gamma, 1),
+	CFGOPT_INT(_T("gfx_gamma_r"), gfx_gamma_ch[0], 1),
+	CFGOPT_INT(_T("gfx_gamma_g"), gfx_gamma_ch[1], 1),
+	CFGOPT_INT(_T("gfx_gamma_b"), gfx_gamma_ch[2], 1),
+	CFGOPT_FLOAT(_T("rtg_vert_zoom_multf"), rtg_vert_zoom_mult),
+	CFGOPT_FLOAT(_T("rtg_horiz_zoom_multf"), rtg_horiz_zoom_mult),
+	CFGOPT_INT(_T("gfx_horizontal_tweak"), gfx_extrawidth, 1),
+
+	CFGOPT_INT(_T("floppy0sound"), floppyslots[0].dfxclick, 1),
+	CFGOPT_INT(_T("floppy1sound"), floppyslots[1].dfxclick, 1),
+	CFGOPT_INT(_T("floppy2sound"), floppyslots[2].dfxclick, 1),
+	CFGOPT_INT(_T("floppy3sound"), floppyslots[3].dfxclick, 1),
+	CFGOPT_INT(_T("floppy_channel_mask"), dfxclickchannelmask, 1),
+	CFGOPT_INT(_T("floppy_volume"), dfxclickvolume, 1),
+
+	CFGOPT_YESNO(_T("use_debugger"), start_debugger),
+	CFGOPT_YESNO(_T("floppy0wp"), floppyslots[0].forcedwriteprotect),
+	CFGOPT_YESNO(_T("floppy1wp"), floppyslots[1].forcedwriteprotect),
+	CFGOPT_YESNO(_T("floppy2wp"), floppyslots[2].forcedwriteprotect),
+	CFGOPT_YESNO(_T("floppy3wp"), floppyslots[3].forcedwriteprotect),
+	CFGOPT_YESNO(_T("sampler_stereo"), sampler_stereo),
+	CFGOPT_YESNO(_T("sound_auto"), sound_auto),
+	CFGOPT_YESNO(_T("sound_cdaudio"), sound_cdaudio),
+	CFGOPT_YESNO(_T("sound_stereo_swap_paula"), sound_stereo_swap_paula),
+	CFGOPT_YESNO(_T("sound_stereo_swap_ahi"), sound_stereo_swap_ahi),
+	CFGOPT_YESNO(_T("avoid_cmov"), avoid_cmov),
+	CFGOPT_YESNO(_T("log_illegal_mem"), illegal_mem),
+	CFGOPT_YESNO(_T("filesys_no_fsdb"), filesys_no_uaefsdb),
+	CFGOPT_YESNO(_T("gfx_blacker_than_black"), gfx_blackerthanblack),
+	CFGOPT_YESNO(_T("gfx_black_frame_insertion"), lightboost_strobo),
+	CFGOPT_YESNO(_T("gfx_flickerfixer"), gfx_scandoubler),
+	CFGOPT_YESNO(_T("gfx_autoresolution_vga"), gfx_autoresolution_vga),
+	CFGOPT_YESNO(_T("magic_mouse"), input_magic_mouse),
+	CFGOPT_YESNO(_T("warp"), turbo_emulation),
+	CFGOPT_YESNO(_T("headless"), headless),
+	CFGOPT_YESNO(_T("clipboard_sharing"), clipboard_sharing),
+	CFGOPT_YESNO(_T("native_code"), native_code),
+	CFGOPT_YESNO(_T("tablet_library"), tablet_library),
+	CFGOPT_YESNO(_T("bsdsocket_emu"), socket_emu),
+};
+
+#define CFGOPT_HASH_SIZE 512
+
+struct cfgopt_index
+{
+	const struct cfgopt *opts;
+	int count;
+	bool init;
+	uae_s16 slot[CFGOPT_HASH_SIZE];
+};
+
+static struct cfgopt_index cfgopt_hardware_index = { cfgopts_hardware, sizeof cfgopts_hardware / sizeof (struct cfgopt) };
+static struct cfgopt_index cfgopt_host_index = { cfgopts_host, sizeof cfgopts_host / sizeof (struct cfgopt) };
+
+static uae_u32 cfgopt_hash (const TCHAR *s)
+{
+	uae_u32 h = 2166136261U;
+	while (*s) {
+		h ^= (uae_u32)*s++;
+		h *= 16777619;
+	}
+	return h & (CFGOPT_HASH_SIZE - 1);
+}
+
+static void cfgopt_initindex (struct cfgopt_index *idx)
+{
+	for (int i = 0; i < CFGOPT_HASH_SIZE; i++)
+		idx->slot[i] = -1;
+	for (int i = 0; i < idx->count; i++) {
+		uae_u32 h = cfgopt_hash (idx->opts[i].name);
+		while (idx->slot[h] >= 0)
+			h = (h + 1) & (CFGOPT_HASH_SIZE - 1);
+		idx->slot[h] = i;
+	}
+	idx->init = true;
+}
+
+static const struct cfgopt *cfgopt_find (struct cfgopt_index *idx, const TCHAR *option)
+{
+	uae_u32 h;
+
+	if (!idx->init)
+		cfgopt_initindex (idx);
+	h = cfgopt_hash (option);
+	while (idx->slot[h] >= 0) {
+		const struct cfgopt *o = &idx->opts[idx->slot[h]];
+		if (!_tcscmp (o->name, option))
+			return o;
+		h = (h + 1) & (CFGOPT_HASH_SIZE - 1);
+	}
+	return NULL;
+}
+
+static int cfgopt_parse (struct uae_prefs *p, struct cfgopt_index *idx, const TCHAR *option, TCHAR *value)
+{
+	const struct cfgopt *o = cfgopt_find (idx, option);
+	uae_u8 *loc;
+
+	if (!o)
+		return 0;
+	loc = (uae_u8*)p + o->offset;
+	switch (o->type)
+	{
+	case CFGTYPE_YESNO:
+		if (o->size == sizeof (bool))
+			cfgfile_yesno (option, value, NULL, (bool*)loc);
+		else
+			cfgfile_yesno (option, value, NULL, (int*)loc);
+		break;
+	case CFGTYPE_INT:
+		cfgfile_intval (option, value, o->name, (unsigned int*)loc, o->scale);
+		break;
+	case CFGTYPE_DOUBLE:
+		cfgfile_doubleval (option, value, NULL, (double*)loc);
+		break;
+	case CFGTYPE_FLOAT:
+		cfgfile_floatval (option, value, o->name, (float*)loc);
+		break;
+	case CFGTYPE_STRVAL:
+		if (o->size == sizeof (bool))
+			cfgfile_strboolval (option, value, o->name, (bool*)loc, o->table, 0);
+		else
+			cfgfile_strval (option, value, o->name, (int*)loc, o->table, 0);
+		break;
+	case CFGTYPE_STRING:
+		cfgfile_string (option, value, o->name, (TCHAR*)loc, o->size / sizeof (TCHAR));
+		break;
+	}
+	return 1;
+}
+
 static int cfgfile_parse_host (struct uae_prefs *p, TCHAR *option, TCHAR *value)
 {
 	int i, v;
@@ -2078,6 +2399,9 @@ static int cfgfile_parse_host (struct uae_prefs *p, TCHAR *option, TCHAR *value)
 		return 0;
 	}
 
+	if (cfgopt_parse (p, &cfgopt_host_index, option, value))
+		return 1;
+
 	for (i = 0; i < MAX_SPARE_DRIVES; i++) {
 		_stprintf (tmpbuf, _T("diskimage%d"), i);
 		if (cfgfile_path (option, value, tmpbuf, p->dfxlist[i], sizeof p->dfxlist[i] / sizeof (TCHAR), &p->path_floppy)) {
@@ -2190,63 +2514,6 @@ static int cfgfile_parse_host (struct uae_prefs *p, TCHAR *option, TCHAR *value)
 		return 1;
 	}
 
-	if (cfgfile_intval (option, value, _T("sound_frequency"), &p->sound_freq, 1)
-		|| cfgfile_intval (option, value, _T("sound_max_buff"), &p->sound_maxbsiz, 1)
-		|| cfgfile_intval (option, value, _T("state_replay_rate"), &p->statecapturerate, 1)
-		|| cfgfile_intval (option, value, _T("state_replay_buffers"), &p->statecapturebuffersize, 1)
-		|| cfgfile_yesno (option, value, _T("state_replay_autoplay"), &p->inprec_autoplay)
-		|| cfgfile_intval (option, value, _T("sound_frequency"), &p->sound_freq, 1)
-		|| cfgfile_intval (option, value, _T("sound_volume"), &p->sound_volume_master, 1)
-		|| cfgfile_intval (option, value, _T("sound_volume_paula"), &p->sound_volume_paula, 1)
-		|| cfgfile_intval (option, value, _T("sound_volume_cd"), &p->sound_volume_cd, 1)
-		|| cfgfile_intval (option, value, _T("sound_volume_ahi"), &p->sound_volume_board, 1)
-		|| cfgfile_intval (option, value, _T("sound_stereo_separation"), &p->sound_stereo_separation, 1)
-		|| cfgfile_intval (option, value, _T("sound_stereo_mixing_delay"), &p->sound_mixed_stereo_delay, 1)
-		|| cfgfile_intval (option, value, _T("sampler_frequency"), &p->sampler_freq, 1)
-		|| cfgfile_intval (option, value, _T("sampler_buffer"), &p->sampler_buffer, 1)
-
-		|| cfgfile_intval (option, value, _T("gfx_framerate"), &p->gfx_framerate, 1)
-		|| cfgfile_intval (option, value, _T("gfx_top_windowed"), &p->gfx_size_win.x, 1)
-		|| cfgfile_intval (option, value, _T("gfx_left_windowed"), &p->gfx_size_win.y, 1)
-		|| cfgfile_intval (option, value, _T("gfx_refreshrate"), &p->gfx_apmode[APMODE_NATIVE].gfx_refreshrate, 1)
-		|| cfgfile_intval (option, value, _T("gfx_refreshrate_rtg"), &p->gfx_apmode[APMODE_RTG].gfx_refreshrate, 1)
-		|| cfgfile_intval (option, value, _T("gfx_autoresolution_delay"), &p->gfx_autoresolution_delay, 1)
-		|| cfgfile_intval (option, value, _T("gfx_backbuffers"), &p->gfx_apmode[APMODE_NATIVE].gfx_backbuffers, 1)
-		|| cfgfile_intval (option, value, _T("gfx_backbuffers_rtg"), &p->gfx_apmode[APMODE_RTG].gfx_backbuffers, 1)
-		|| cfgfile_yesno (option, value, _T("gfx_interlace"), &p->gfx_apmode[APMODE_NATIVE].gfx_interlaced)
-		|| cfgfile_yesno (option, value, _T("gfx_interlace_rtg"), &p->gfx_apmode[APMODE_RTG].gfx_interlaced)
-		
-		|| cfgfile_intval (option, value, _T("gfx_center_horizontal_position"), &p->gfx_xcenter_pos, 1)
-		|| cfgfile_intval (option, value, _T("gfx_center_vertical_position"), &p->gfx_ycenter_pos, 1)
-		|| cfgfile_intval (option, value, _T("gfx_center_horizontal_size"), &p->gfx_xcenter_size, 1)
-		|| cfgfile_intval (option, value, _T("gfx_center_vertical_size"), &p->gfx_ycenter_size, 1)
-
-		|| cfgfile_intval (option, value, _T("filesys_max_size"), &p->filesys_limit, 1)
-		|| cfgfile_intval (option, value, _T("filesys_max_name_length"), &p->filesys_max_name, 1)
-		|| cfgfile_intval (option, value, _T("filesys_max_file_size"), &p->filesys_max_file_size, 1)
-		|| cfgfile_yesno (option, value, _T("filesys_inject_icons"), &p->filesys_inject_icons)
-		|| cfgfile_string (option, value, _T("filesys_inject_icons_drawer"), p->filesys_inject_icons_drawer, sizeof p->filesys_inject_icons_drawer / sizeof (TCHAR))
-		|| cfgfile_string (option, value, _T("filesys_inject_icons_project"), p->filesys_inject_icons_project, sizeof p->filesys_inject_icons_project / sizeof (TCHAR))
-		|| cfgfile_string (option, value, _T("filesys_inject_icons_tool"), p->filesys_inject_icons_tool, sizeof p->filesys_inject_icons_tool / sizeof (TCHAR))
-
-		|| cfgfile_intval (option, value, _T("gfx_luminance"), &p->gfx_luminance, 1)
-		|| cfgfile_intval (option, value, _T("gfx_contrast"), &p->gfx_contrast, 1)
-		|| cfgfile_intval (option, value, _T("gfx_gamma"), &p->gfx_gamma, 1)
-		|| cfgfile_intval (option, value, _T("gfx_gamma_r"), &p->gfx_gamma_ch[0], 1)
-		|| cfgfile_intval (option, value, _T("gfx_gamma_g"), &p->gfx_gamma_ch[1], 1)
-		|| cfgfile_intval (option, value, _T("gfx_gamma_b"), &p->gfx_gamma_ch[2], 1)
-		|| cfgfile_floatval (option, value, _T("rtg_vert_zoom_multf"), &p->rtg_vert_zoom_mult)
-		|| cfgfile_floatval (option, value, _T("rtg_horiz_zoom_multf"), &p->rtg_horiz_zoom_mult)
-		|| cfgfile_intval (option, value, _T("gfx_horizontal_tweak"), &p->gfx_extrawidth, 1)
-
-		|| cfgfile_intval (option, value, _T("floppy0sound"), &p->floppyslots[0].dfxclick, 1)
-		|| cfgfile_intval (option, value, _T("floppy1sound"), &p->floppyslots[1].dfxclick, 1)
-		|| cfgfile_intval (option, value, _T("floppy2sound"), &p->floppyslots[2].dfxclick, 1)
-		|| cfgfile_intval (option, value, _T("floppy3sound"), &p->floppyslots[3].dfxclick, 1)
-		|| cfgfile_intval (option, value, _T("floppy_channel_mask"), &p->dfxclickchannelmask, 1)
-		|| cfgfile_intval (option, value, _T("floppy_volume"), &p->dfxclickvolume, 1))
-		return 1;
-
 	if (cfgfile_path (option, value, _T("floppy0soundext"), p->floppyslots[0].dfxclickexternal, sizeof p->floppyslots[0].dfxclickexternal / sizeof (TCHAR))
 		|| cfgfile_path (option, value, _T("floppy1soundext"), p->floppyslots[1].dfxclickexternal, sizeof p->floppyslots[1].dfxclickexternal / sizeof (TCHAR))
 		|| cfgfile_path (option, value, _T("floppy2soundext"), p->floppyslots[2].dfxclickexternal, sizeof p->floppyslots[2].dfxclickexternal / sizeof (TCHAR))
@@ -2256,32 +2523,6 @@ static int cfgfile_parse_host (struct uae_prefs *p, TCHAR *option, TCHAR *value)
 		|| cfgfile_string (option, value, _T("config_description"), p->description, sizeof p->description / sizeof (TCHAR)))
 		return 1;
 
-	if (cfgfile_yesno (option, value, _T("use_debugger"), &p->start_debugger)
-		|| cfgfile_yesno (option, value, _T("floppy0wp"), &p->floppyslots[0].forcedwriteprotect)
-		|| cfgfile_yesno (option, value, _T("floppy1wp"), &p->floppyslots[1].forcedwriteprotect)
-		|| cfgfile_yesno (option, value, _T("floppy2wp"), &p->floppyslots[2].forcedwriteprotect)
-		|| cfgfile_yesno (option, value, _T("floppy3wp"), &p->floppyslots[3].forcedwriteprotect)
-		|| cfgfile_yesno (option, value, _T("sampler_stereo"), &p->sampler_stereo)
-		|| cfgfile_yesno (option, value, _T("sound_auto"), &p->sound_auto)
-		|| cfgfile_yesno (option, value, _T("sound_cdaudio"), &p->sound_cdaudio)
-		|| cfgfile_yesno (option, value, _T("sound_stereo_swap_paula"), &p->sound_stereo_swap_paula)
-		|| cfgfile_yesno (option, value, _T("sound_stereo_swap_ahi"), &p->sound_stereo_swap_ahi)
-		|| cfgfile_yesno (option, value, _T("avoid_cmov"), &p->avoid_cmov)
-		|| cfgfile_yesno (option, value, _T("log_illegal_mem"), &p->illegal_mem)
-		|| cfgfile_yesno (option, value, _T("filesys_no_fsdb"), &p->filesys_no_uaefsdb)
-		|| cfgfile_yesno (option, value, _T("gfx_blacker_than_black"), &p->gfx_blackerthanblack)
-		|| cfgfile_yesno (option, value, _T("gfx_black_frame_insertion"), &p->lightboost_strobo)
-		|| cfgfile_yesno (option, value, _T("gfx_flickerfixer"), &p->gfx_scandoubler)
-		|| cfgfile_yesno (option, value, _T("gfx_autoresolution_vga"), &p->gfx_autoresolution_vga)
-		|| cfgfile_yesno (option, value, _T("magic_mouse"), &p->input_magic_mouse)
-		|| cfgfile_yesno (option, value, _T("warp"), &p->turbo_emulation)
-		|| cfgfile_yesno (option, value, _T("headless"), &p->headless)
-		|| cfgfile_yesno (option, value, _T("clipboard_sharing"), &p->clipboard_sharing)
-		|| cfgfile_yesno (option, value, _T("native_code"), &p->native_code)
-		|| cfgfile_yesno (option, value, _T("tablet_library"), &p->tablet_library)
-		|| cfgfile_yesno (option, value, _T("bsdsocket_emu"), &p->socket_emu))
-		return 1;
-
 	if (cfgfile_strval (option, value, _T("sound_output"), &p->produce_sound, soundmode1, 1)
 		|| cfgfile_strval (option, value, _T("sound_output"), &p->produce_sound, soundmode2, 0)
 		|| cfgfile_strval (option, value, _T("sound_interpol"), &p->sound_interpol, interpolmode, 0)
@@ -3916,6 +4157,9 @@ static int cfgfile_parse_hardware (struct uae_prefs *p, const TCHAR *option, TCH
 	TCHAR *section = 0;
 	TCHAR tmpbuf[CONFIG_BLEN];
 
+	if (cfgopt_parse (p, &cfgopt_hardware_index, option, value))
+		return 1;
+
 	if (cfgfile_yesno (option, value, _T("cpu_cycle_exact"), &p->cpu_cycle_exact)
 		|| cfgfile_yesno (option, value, _T("blitter_cycle_exact"), &p->blitter_cycle_exact)) {
 			if (p->cpu_model >= 68020 && p->cachesize > 0)
@@ -3953,128 +4197,7 @@ static int cfgfile_parse_hardware (struct uae_prefs *p, const TCHAR *option, TCH
 	if (cfgfile_string (option, value, _T("a2065"), p->a2065name, sizeof p->a2065name / sizeof (TCHAR)))
 		return 1;
 
-	if (cfgfile_yesno (option, value, _T("immediate_blits"), &p->immediate_blits)
-		|| cfgfile_yesno (option, value, _T("fpu_no_unimplemented"), &p->fpu_no_unimplemented)
-		|| cfgfile_yesno (option, value, _T("cpu_no_unimplemented"), &p->int_no_unimplemented)
-		|| cfgfile_yesno (option, value, _T("cd32cd"), &p->cs_cd32cd)
-		|| cfgfile_yesno (option, value, _T("cd32c2p"), &p->cs_cd32c2p)
-		|| cfgfile_yesno(option, value, _T("cd32nvram"), &p->cs_cd32nvram)
-		|| cfgfile_yesno(option, value, _T("cd32fmv"), &p->cs_cd32fmv)
-		|| cfgfile_yesno(option, value, _T("cdtvcd"), &p->cs_cdtvcd)
-		|| cfgfile_yesno(option, value, _T("cdtv-cr"), &p->cs_cdtvcr)
-		|| cfgfile_yesno (option, value, _T("cdtvram"), &p->cs_cdtvram)
-		|| cfgfile_yesno (option, value, _T("a1000ram"), &p->cs_a1000ram)
-		|| cfgfile_yesno (option, value, _T("pcmcia"), &p->cs_pcmcia)
-		|| cfgfile_yesno (option, value, _T("scsi_cdtv"), &p->cs_cdtvscsi)
-		|| cfgfile_yesno (option, value, _T("cia_overlay"), &p->cs_ciaoverlay)
-		|| cfgfile_yesno (option, value, _T("bogomem_fast"), &p->cs_slowmemisfast)
-		|| cfgfile_yesno (option, value, _T("ksmirror_e0"), &p->cs_ksmirror_e0)
-		|| cfgfile_yesno (option, value, _T("ksmirror_a8"), &p->cs_ksmirror_a8)
-		|| cfgfile_yesno (option, value, _T("resetwarning"), &p->cs_resetwarning)
-		|| cfgfile_yesno (option, value, _T("cia_todbug"), &p->cs_ciatodbug)
-		|| cfgfile_yesno (option, value, _T("denise_noehb"), &p->cs_denisenoehb)
-		|| cfgfile_yesno (option, value, _T("ics_agnus"), &p->cs_dipagnus)
-		|| cfgfile_yesno (option, value, _T("z3_autoconfig"), &p->cs_z3autoconfig)
-		|| cfgfile_yesno (option, value, _T("1mchipjumper"), &p->cs_1mchipjumper)
-		|| cfgfile_yesno (option, value, _T("agnus_bltbusybug"), &p->cs_agnusbltbusybug)
-		|| cfgfile_yesno (option, value, _T("fastmem_autoconfig"), &p->fastmem_autoconfig)
-		|| cfgfile_yesno (option, value, _T("gfxcard_hardware_vblank"), &p->rtg_hardwareinterrupt)
-		|| cfgfile_yesno (option, value, _T("gfxcard_hardware_sprite"), &p->rtg_hardwaresprite)
-		|| cfgfile_yesno (option, value, _T("synchronize_clock"), &p->tod_hack)
-
-		|| cfgfile_yesno (option, value, _T("kickshifter"), &p->kickshifter)
-		|| cfgfile_yesno (option, value, _T("ks_write_enabled"), &p->rom_readwrite)
-		|| cfgfile_yesno (option, value, _T("ntsc"), &p->ntscmode)
-		|| cfgfile_yesno (option, value, _T("sana2"), &p->sana2)
-		|| cfgfile_yesno (option, value, _T("genlock"), &p->genlock)
-		|| cfgfile_yesno (option, value, _T("cpu_compatible"), &p->cpu_compatible)
-		|| cfgfile_yesno(option, value, _T("cpu_24bit_addressing"), &p->address_space_24)
-		|| cfgfile_yesno(option, value, _T("cpu_reset_pause"), &p->reset_delay)
-		|| cfgfile_yesno(option, value, _T("parallel_on_demand"), &p->parallel_demand)
-		|| cfgfile_yesno (option, value, _T("parallel_postscript_emulation"), &p->parallel_postscript_emulation)
-		|| cfgfile_yesno (option, value, _T("parallel_postscript_detection"), &p->parallel_postscript_detection)
-		|| cfgfile_yesno (option, value, _T("serial_on_demand"), &p->serial_demand)
-		|| cfgfile_yesno (option, value, _T("serial_hardware_ctsrts"), &p->serial_hwctsrts)
-		|| cfgfile_yesno (option, value, _T("serial_direct"), &p->serial_direct)
-		|| cfgfile_yesno (option, value, _T("fpu_strict"), &p->fpu_strict)
-		|| cfgfile_yesno (option, value, _T("fpu_softfloat"), &p->fpu_softfloat)
-		|| cfgfile_yesno (option, value, _T("comp_nf"), &p->compnf)
-		|| cfgfile_yesno (option, value, _T("comp_constjump"), &p->comp_constjump)
-		|| cfgfile_yesno (option, value, _T("comp_oldsegv"), &p->comp_oldsegv)
-		|| cfgfile_yesno (option, value, _T("compforcesettings"), &dummybool)
-		|| cfgfile_yesno (option, value, _T("compfpu"), &p->compfpu)
-		|| cfgfile_yesno (option, value, _T("comp_midopt"), &p->comp_midopt)
-		|| cfgfile_yesno (option, value, _T("comp_lowopt"), &p->comp_lowopt)
-		|| cfgfile_yesno (option, value, _T("rtg_nocustom"), &p->picasso96_nocustom)
-		|| cfgfile_yesno (option, value, _T("floppy_write_protect"), &p->floppy_read_only)
-		|| cfgfile_yesno (option, value, _T("uae_hide_autoconfig"), &p->uae_hide_autoconfig)
-		|| cfgfile_yesno (option, value, _T("toccata"), &p->sound_toccata)
-		|| cfgfile_yesno (option, value, _T("toccata_mixer"), &p->sound_toccata_mixer)
-		|| cfgfile_yesno (option, value, _T("uaeserial"), &p->uaeserial))
-		return 1;
-
-	if (cfgfile_intval (option, value, _T("cachesize"), &p->cachesize, 1)
-		|| cfgfile_intval (option, value, _T("cd32nvram_size"), &p->cs_cd32nvram_size, 1024)
-		|| cfgfile_intval (option, value, _T("chipset_hacks"), &p->cs_hacks, 1)
-		|| cfgfile_intval (option, value, _T("serial_stopbits"), &p->serial_stopbits, 1)
-		|| cfgfile_intval (option, value, _T("cpu060_revision"), &p->cpu060_revision, 1)
-		|| cfgfile_intval (option, value, _T("fpu_revision"), &p->fpu_revision, 1)
-		|| cfgfile_intval (option, value, _T("cdtvramcard"), &p->cs_cdtvcard, 1)
-		|| cfgfile_intval (option, value, _T("fatgary"), &p->cs_fatgaryrev, 1)
-		|| cfgfile_intval (option, value, _T("ramsey"), &p->cs_ramseyrev, 1)
-		|| cfgfile_doubleval (option, value, _T("chipset_refreshrate"), &p->chipset_refreshrate)
-		|| cfgfile_intval(option, value, _T("cpuboardmem1_size"), &p->cpuboardmem1_size, 0x100000)
-		|| cfgfile_intval(option, value, _T("cpuboardmem2_size"), &p->cpuboardmem2_size, 0x100000)
-		|| cfgfile_intval(option, value, _T("fastmem_size"), &p->fastmem_size, 0x100000)
-		|| cfgfile_intval(option, value, _T("fastmem_size_k"), &p->fastmem_size, 1024)
-		|| cfgfile_intval (option, value, _T("fastmem2_size"), &p->fastmem2_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("fastmem2_size_k"), &p->fastmem2_size, 1024)
-		|| cfgfile_intval (option, value, _T("mem25bit_size"), &p->mem25bit_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("a3000mem_size"), &p->mbresmem_low_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("mbresmem_size"), &p->mbresmem_high_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("z3mem_size"), &p->z3fastmem_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("z3mem2_size"), &p->z3fastmem2_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("megachipmem_size"), &p->z3chipmem_size, 0x100000)
-		|| cfgfile_intval (option, value, _T("z3mem_start"), &p->z3autoconfig_start, 1)
-		|| cfgfile_intval (option, value, _T("bogomem_size"), &p->bogomem_size, 0x40000)
-		|| cfgfile_intval (option, value, _T("gfxcard_size"), &p->rtgmem_size, 0x100000)
-		|| cfgfile_strval(option, value, _T("gfxcard_type"), &p->rtgmem_type, rtgtype, 0)
-		|| cfgfile_intval(option, value, _T("rtg_modes"), &p->picasso96_modeflags, 1)
-		|| cfgfile_intval (option, value, _T("floppy_speed"), &p->floppy_speed, 1)
-		|| cfgfile_intval (option, value, _T("cd_speed"), &p->cd_speed, 1)
-		|| cfgfile_intval (option, value, _T("floppy_write_length"), &p->floppy_write_length, 1)
-		|| cfgfile_intval (option, value, _T("floppy_random_bits_min"), &p->floppy_random_bits_min, 1)
-		|| cfgfile_intval (option, value, _T("floppy_random_bits_max"), &p->floppy_random_bits_max, 1)
-		|| cfgfile_intval (option, value, _T("nr_floppies"), &p->nr_floppies, 1)
-		|| cfgfile_intval (option, value, _T("floppy0type"), &p->floppyslots[0].dfxtype, 1)
-		|| cfgfile_intval (option, value, _T("floppy1type"), &p->floppyslots[1].dfxtype, 1)
-		|| cfgfile_intval (option, value, _T("floppy2type"), &p->floppyslots[2].dfxtype, 1)
-		|| cfgfile_intval (option, value, _T("floppy3type"), &p->floppyslots[3].dfxtype, 1)
-		|| cfgfile_intval (option, value, _T("maprom"), &p->maprom, 1)
-		|| cfgfile_intval (option, value, _T("parallel_autoflush"), &p->parallel_autoflush_time, 1)
-		|| cfgfile_intval (option, value, _T("uae_hide"), &p->uae_hide, 1)
-		|| cfgfile_intval (option, value, _T("cpu_frequency"), &p->cpu_frequency, 1)
-		|| cfgfile_intval (option, value, _T("kickstart_ext_rom_file2addr"), &p->romextfile2addr, 1)
-		|| cfgfile_intval (option, value, _T("catweasel"), &p->catweasel, 1))
-		return 1;
-
-	if (cfgfile_strval (option, value, _T("comp_trustbyte"), &p->comptrustbyte, compmode, 0)
-		|| cfgfile_strval (option, value, _T("rtc"), &p->cs_rtc, rtctype, 0)
-		|| cfgfile_strval (option, value, _T("ciaatod"), &p->cs_ciaatod, ciaatodmode, 0)
-		|| cfgfile_strval (option, value, _T("ide"), &p->cs_ide, idemode, 0)
-		|| cfgfile_strval (option, value, _T("scsi"), &p->scsi, scsimode, 0)
-		|| cfgfile_strval (option, value, _T("comp_trustword"), &p->comptrustword, compmode, 0)
-		|| cfgfile_strval (option, value, _T("comp_trustlong"), &p->comptrustlong, compmode, 0)
-		|| cfgfile_strval (option, value, _T("comp_trustnaddr"), &p->comptrustnaddr, compmode, 0)
-		|| cfgfile_strval (option, value, _T("collision_level"), &p->collision_level, collmode, 0)
-		|| cfgfile_strval (option, value, _T("parallel_matrix_emulation"), &p->parallel_matrix_emulation, epsonprinter, 0)
-		|| cfgfile_strval (option, value, _T("monitoremu"), &p->monitoremu, specialmonitors, 0)
-		|| cfgfile_strval (option, value, _T("waiting_blits"), &p->waiting_blits, waitblits, 0)
-		|| cfgfile_strval (option, value, _T("floppy_auto_extended_adf"), &p->floppy_auto_ext2, autoext2, 0)
-		|| cfgfile_strval (option, value,  _T("z3mapping"), &p->z3_mapping_mode, z3mapping, 0)
-		|| cfgfile_strval (option, value,  _T("scsidev_mode"), &p->uaescsidevmode, uaescsidevmodes, 0)
-		|| cfgfile_strval (option, value,  _T("boot_rom_uae"), &p->boot_rom, uaebootrom, 0)
-		|| cfgfile_strboolval (option, value, _T("comp_flushmode"), &p->comp_hardflush, flushmode, 0))
+	if (cfgfile_yesno (option, value, _T("compforcesettings"), &dummybool))
 		return 1;
 
 	if (cfgfile_path (option, value, _T("kickstart_rom_file"), p->romfile, sizeof p->romfile / sizeof (TCHAR), &p->path_rom)
@@ -5722,6 +5845,7 @@ void default_prefs (struct uae_prefs *p, int type)
 	p->compnf = 1;
 	p->comp_hardflush = 0;
 	p->comp_constjump = 1;
+	p->comp_keepblocks = 0;
 	p->comp_oldsegv = 0;
 	p->compfpu = 1;
 	p->cachesize = 0;
@@ -5781,6 +5905,7 @@ void default_prefs (struct uae_prefs *p, int type)
 	p->cpu_idle = 0;
 	p->turbo_emulation = 0;
 	p->headless = 0;
+	p->benchmark_frames = 0;
 	p->catweasel = 0;
 	p->tod_hack = 0;
 	p->maprom = 0;
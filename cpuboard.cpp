@@ -299,7 +299,7 @@ static addrbank blizzardram_bank = {
 	blizzardram_lget, blizzardram_wget, blizzardram_bget,
 	blizzardram_lput, blizzardram_wput, blizzardram_bput,
 	blizzardram_xlate, blizzardram_check, NULL, NULL, _T("CPUBoard RAM"),
-	blizzardram_lget, blizzardram_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	blizzardram_lget, blizzardram_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 DECLARE_MEMORY_FUNCTIONS(blizzardea);
@@ -55,6 +55,8 @@ static bool locked_rmw_cycle;
 static bool ismoves;
 bool mmu_ttr_enabled;
 int mmu_atc_ways;
+struct mmu_fast_line mmu_fast_array[ATC_TYPE][2][MMU_FAST_SLOTS];
+static bool mmu_fast_enabled;
 
 int mmu040_movem;
 uaecptr mmu040_movem_ea;
@@ -105,6 +107,45 @@ void mmu_make_transparent_region(uaecptr baseaddr, uae_u32 size, int datamode)
 void mmu_tt_modified (void)
 {
 	mmu_ttr_enabled = ((regs.dtt0 | regs.dtt1 | regs.itt0 | regs.itt1) & MMU_TTR_BIT_ENABLED) != 0;
+	mmu_flush_fast();
+}
+
+void mmu_flush_fast(void)
+{
+	memset(mmu_fast_array, 0, sizeof mmu_fast_array);
+}
+
+/* drop all fast slots of the logical page containing addr */
+void mmu_flush_fast_page(uaecptr addr)
+{
+	int type, rw, index, i;
+
+	addr &= mmu_pagemaski;
+	for (i = 0; i <= (mmu_pagemask >> 12); i++) {
+		index = ((addr >> 12) + i) & (MMU_FAST_SLOTS - 1);
+		for (type = 0; type < ATC_TYPE; type++) {
+			for (rw = 0; rw < 2; rw++)
+				mmu_fast_array[type][rw][index].tag = 0;
+		}
+	}
+}
+
+/* called on ATC hit, enter the page if it is plain memory */
+void mmu_fast_fill(uaecptr addr, bool data, bool write, struct mmu_atc_line *cl)
+{
+	struct mmu_fast_line *fl;
+	addrbank *ab;
+
+	if (!mmu_fast_enabled)
+		return;
+	ab = &get_mem_bank(cl->phys);
+	if (!(ab->flags & ABFLAG_DIRECTACCESS) || (write && (ab->flags & ABFLAG_ROM)))
+		return;
+	if (!ab->baseaddr || !ab->check(cl->phys, mmu_pagemask + 1))
+		return;
+	fl = &mmu_fast_array[data][write][(addr >> 12) & (MMU_FAST_SLOTS - 1)];
+	fl->tag = (addr & ~0xfff) | (mmu_is_super >> 30) | 1;
+	fl->host = get_real_address(cl->phys | (addr & mmu_pagemask & ~0xfff));
 }
 
 
@@ -479,6 +520,7 @@ static uaecptr mmu_fill_atc(uaecptr addr, bool super, bool data, bool write, str
 {
 	uae_u32 desc;
 
+	mmu_flush_fast_page(addr);
 	*status = 0;
 	SAVE_EXCEPTION;
 	TRY(prb) {
@@ -1225,6 +1267,7 @@ void REGPARAM2 mmu_flush_atc(uaecptr addr, bool super, bool global)
 			}
 		}
 	}	
+	mmu_flush_fast_page(addr);
 }
 
 void REGPARAM2 mmu_flush_atc_all(bool global)
@@ -1239,6 +1282,7 @@ void REGPARAM2 mmu_flush_atc_all(bool global)
 			}
 		}
 	}
+	mmu_flush_fast();
 }
 
 void REGPARAM2 mmu_set_funcs(void)
@@ -1254,6 +1298,7 @@ void REGPARAM2 mmu_set_funcs(void)
 		x_phys_put_byte = put_byte_cache_040;
 		x_phys_put_word = put_word_cache_040;
 		x_phys_put_long = put_long_cache_040;
+		mmu_fast_enabled = false;
 	} else {
 		x_phys_get_iword = phys_get_word;
 		x_phys_get_ilong = phys_get_long;
@@ -1263,7 +1308,9 @@ void REGPARAM2 mmu_set_funcs(void)
 		x_phys_put_byte = phys_put_byte;
 		x_phys_put_word = phys_put_word;
 		x_phys_put_long = phys_put_long;
+		mmu_fast_enabled = true;
 	}
+	mmu_flush_fast();
 }
 
 void REGPARAM2 mmu_reset(void)
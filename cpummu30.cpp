@@ -130,6 +130,50 @@ static struct {
     uae_u16 status;
 } mmu030;
 
+/* Hashed lookup in front of the ATC. The ATC above stays the architectural
+ * state (replacement, history bits, PTEST), a hash slot only remembers which
+ * ATC line translated a page/fc pair and, for plain memory banks, the host
+ * address of the physical page. Separate tables for reads and writes, write
+ * slots exist only for pages that are not write protected and have M set.
+ * A slot is valid while its serial matches the serial of its ATC line, every
+ * invalidation or replacement of a line bumps the line's serial. */
+#define ATC030_HASH_SIZE 256
+
+typedef struct {
+	uae_u32 tag;
+	uae_u32 serial;
+	int line;
+	uaecptr physical;
+	uae_u8 *host;
+} MMU030_ATC_HASH;
+
+static MMU030_ATC_HASH atc030_hash[2][ATC030_HASH_SIZE];
+static uae_u32 atc030_serial[ATC030_NUM_ENTRIES];
+static bool mmu030_ifetch_direct;
+
+static ALWAYS_INLINE MMU030_ATC_HASH *mmu030_hash_slot(uaecptr addr, uae_u32 fc, int write)
+{
+	return &atc030_hash[write][((addr >> mmu030.translation.page.size) ^ fc) & (ATC030_HASH_SIZE - 1)];
+}
+
+static ALWAYS_INLINE uae_u32 mmu030_hash_tag(uaecptr addr, uae_u32 fc)
+{
+	return (addr & mmu030.translation.page.imask) | (fc << 1) | 1;
+}
+
+static void mmu030_atc_invalidate(int l)
+{
+	mmu030.atc[l].logical.valid = false;
+	atc030_serial[l]++;
+}
+
+/* Drops all hash slots, ATC contents are not touched */
+void mmu030_flush_atc_hash(void)
+{
+	for (int i = 0; i < ATC030_NUM_ENTRIES; i++)
+		atc030_serial[i]++;
+}
+
 
 
 /* MMU Status Register
@@ -282,6 +326,9 @@ bool mmu_op30_pmove (uaecptr pc, uae_u32 opcode, uae_u16 next, uaecptr extra)
     if (!fd && !rw && !(preg==0x18)) {
         mmu030_flush_atc_all();
     }
+	/* hash slots depend on TC page size and TT misses, FD does not keep them */
+	if (!rw && preg != 0x18)
+		mmu030_flush_atc_hash();
 	tt_enabled = (tt0_030 & TT_ENABLE) || (tt1_030 & TT_ENABLE);
 	return false;
 }
@@ -428,7 +475,7 @@ void mmu030_flush_atc_fc(uae_u32 fc_base, uae_u32 fc_mask) {
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
         if (((fc_base&fc_mask)==(mmu030.atc[i].logical.fc&fc_mask)) &&
             mmu030.atc[i].logical.valid) {
-            mmu030.atc[i].logical.valid = false;
+            mmu030_atc_invalidate(i);
 #if MMU030_OP_DBG_MSG
             write_log(_T("ATC: Flushing %08X\n"), mmu030.atc[i].physical.addr);
 #endif
@@ -445,7 +492,7 @@ void mmu030_flush_atc_page_fc(uaecptr logical_addr, uae_u32 fc_base, uae_u32 fc_
         if (((fc_base&fc_mask)==(mmu030.atc[i].logical.fc&fc_mask)) &&
             (mmu030.atc[i].logical.addr == logical_addr) &&
             mmu030.atc[i].logical.valid) {
-            mmu030.atc[i].logical.valid = false;
+            mmu030_atc_invalidate(i);
 #if MMU030_OP_DBG_MSG
             write_log(_T("ATC: Flushing %08X\n"), mmu030.atc[i].physical.addr);
 #endif
@@ -460,7 +507,7 @@ void mmu030_flush_atc_page(uaecptr logical_addr) {
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
         if ((mmu030.atc[i].logical.addr == logical_addr) &&
             mmu030.atc[i].logical.valid) {
-            mmu030.atc[i].logical.valid = false;
+            mmu030_atc_invalidate(i);
 #if MMU030_OP_DBG_MSG
             write_log(_T("ATC: Flushing %08X\n"), mmu030.atc[i].physical.addr);
 #endif
@@ -475,7 +522,7 @@ void mmu030_flush_atc_all(void) {
 #endif
 	int i;
     for (i=0; i<ATC030_NUM_ENTRIES; i++) {
-        mmu030.atc[i].logical.valid = false;
+        mmu030_atc_invalidate(i);
     }
 }
 
@@ -733,6 +780,7 @@ static void mmu030_do_fake_prefetch(void)
 
 bool mmu030_decode_tc(uae_u32 TC)
 {
+	mmu030_flush_atc_hash();
     /* Set MMU condition */    
     if (TC & TC_ENABLE_TRANSLATION) {
 		if (!mmu030.enabled)
@@ -1481,6 +1529,7 @@ uae_u32 mmu030_table_search(uaecptr addr, uae_u32 fc, bool write, int level) {
 	}
 
     mmu030_atc_handle_history_bit(i);
+    atc030_serial[i]++;
     
     /* Create ATC entry */
     mmu030.atc[i].logical.addr = addr & mmu030.translation.page.imask; /* delete page index bits */
@@ -1846,7 +1895,7 @@ int mmu030_logical_is_in_atc(uaecptr addr, uae_u32 fc, bool write) {
 					atcindextable[offset] = index;
 					return index;
 				} else {
-					mmu030.atc[index].logical.valid = false;
+					mmu030_atc_invalidate(index);
 				}
 		}
 		index++;
@@ -1876,6 +1925,40 @@ void mmu030_atc_handle_history_bit(int entry_num) {
 }
 
 
+/* Called after the ATC resolved an access that did not match TT0/TT1 */
+static void mmu030_hash_add(uaecptr addr, uae_u32 fc, int write, int l)
+{
+	MMU030_ATC_LINE *a;
+	MMU030_ATC_HASH *h;
+	addrbank *ab;
+
+	if (l < 0)
+		return;
+	a = &mmu030.atc[l];
+	if (a->physical.bus_error || (write && (a->physical.write_protect || !a->physical.modified)))
+		return;
+	h = mmu030_hash_slot(addr, fc, write);
+	h->tag = mmu030_hash_tag(addr, fc);
+	h->serial = atc030_serial[l];
+	h->line = l;
+	h->physical = a->physical.addr & mmu030.translation.page.imask;
+	h->host = NULL;
+	ab = &get_mem_bank(h->physical);
+	if ((ab->flags & ABFLAG_DIRECTACCESS) && !(write && (ab->flags & ABFLAG_ROM)) &&
+		ab->baseaddr && ab->check(h->physical, 1 << mmu030.translation.page.size))
+		h->host = get_real_address(h->physical);
+}
+
+static ALWAYS_INLINE MMU030_ATC_HASH *mmu030_hash_lookup(uaecptr addr, uae_u32 fc, int write)
+{
+	MMU030_ATC_HASH *h = mmu030_hash_slot(addr, fc, write);
+	if (h->tag != mmu030_hash_tag(addr, fc) || h->serial != atc030_serial[h->line])
+		return NULL;
+	if (!mmu030.atc[h->line].mru)
+		mmu030_atc_handle_history_bit(h->line);
+	return h;
+}
+
 /* Memory access functions:
  * If the address matches one of the transparent translation registers
  * use it directly as physical address, else check ATC for the
@@ -1884,6 +1967,14 @@ void mmu030_atc_handle_history_bit(int entry_num) {
  */
 
 void mmu030_put_long(uaecptr addr, uae_u32 val, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 1);
+	if (h) {
+		if (h->host)
+			do_put_mem_long((uae_u32*)(h->host + (addr & mmu030.translation.page.mask)), val);
+		else
+			phys_put_long(h->physical + (addr & mmu030.translation.page.mask), val);
+		return;
+	}
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,true)) || (fc==7)) {
@@ -1893,15 +1984,23 @@ void mmu030_put_long(uaecptr addr, uae_u32 val, uae_u32 fc) {
 
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
 
-    if (atc_line_num>=0) {
-        mmu030_put_long_atc(addr, val, atc_line_num, fc);
-    } else {
+    if (atc_line_num<0) {
         mmu030_table_search(addr,fc,true,0);
-        mmu030_put_long_atc(addr, val, mmu030_logical_is_in_atc(addr,fc,true), fc);
+        atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
     }
+    mmu030_hash_add(addr, fc, 1, atc_line_num);
+    mmu030_put_long_atc(addr, val, atc_line_num, fc);
 }
 
 void mmu030_put_word(uaecptr addr, uae_u16 val, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 1);
+	if (h) {
+		if (h->host)
+			do_put_mem_word((uae_u16*)(h->host + (addr & mmu030.translation.page.mask)), val);
+		else
+			phys_put_word(h->physical + (addr & mmu030.translation.page.mask), val);
+		return;
+	}
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,true)) || (fc==7)) {
@@ -1911,15 +2010,23 @@ void mmu030_put_word(uaecptr addr, uae_u16 val, uae_u32 fc) {
     
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
     
-    if (atc_line_num>=0) {
-        mmu030_put_word_atc(addr, val, atc_line_num, fc);
-    } else {
+    if (atc_line_num<0) {
         mmu030_table_search(addr, fc, true, 0);
-        mmu030_put_word_atc(addr, val, mmu030_logical_is_in_atc(addr,fc,true), fc);
+        atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
     }
+    mmu030_hash_add(addr, fc, 1, atc_line_num);
+    mmu030_put_word_atc(addr, val, atc_line_num, fc);
 }
 
 void mmu030_put_byte(uaecptr addr, uae_u8 val, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 1);
+	if (h) {
+		if (h->host)
+			h->host[addr & mmu030.translation.page.mask] = val;
+		else
+			phys_put_byte(h->physical + (addr & mmu030.translation.page.mask), val);
+		return;
+	}
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr, fc, true)) || (fc==7)) {
@@ -1929,15 +2036,21 @@ void mmu030_put_byte(uaecptr addr, uae_u8 val, uae_u32 fc) {
     
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
 
-    if (atc_line_num>=0) {
-        mmu030_put_byte_atc(addr, val, atc_line_num, fc);
-    } else {
+    if (atc_line_num<0) {
         mmu030_table_search(addr, fc, true, 0);
-        mmu030_put_byte_atc(addr, val, mmu030_logical_is_in_atc(addr,fc,true), fc);
+        atc_line_num = mmu030_logical_is_in_atc(addr, fc, true);
     }
+    mmu030_hash_add(addr, fc, 1, atc_line_num);
+    mmu030_put_byte_atc(addr, val, atc_line_num, fc);
 }
 
 uae_u32 mmu030_get_ilong(uaecptr addr, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 0);
+	if (h) {
+		if (h->host && mmu030_ifetch_direct)
+			return do_get_mem_long((uae_u32*)(h->host + (addr & mmu030.translation.page.mask)));
+		return x_phys_get_ilong(h->physical + (addr & mmu030.translation.page.mask));
+	}
 
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr, fc, false)) || (fc == 7)) {
@@ -1946,15 +2059,20 @@ uae_u32 mmu030_get_ilong(uaecptr addr, uae_u32 fc) {
 
 	int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
-	if (atc_line_num >= 0) {
-		return mmu030_get_ilong_atc(addr, atc_line_num, fc);
-	}
-	else {
+	if (atc_line_num < 0) {
 		mmu030_table_search(addr, fc, false, 0);
-		return mmu030_get_ilong_atc(addr, mmu030_logical_is_in_atc(addr, fc, false), fc);
+		atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 	}
+	mmu030_hash_add(addr, fc, 0, atc_line_num);
+	return mmu030_get_ilong_atc(addr, atc_line_num, fc);
 }
 uae_u32 mmu030_get_long(uaecptr addr, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 0);
+	if (h) {
+		if (h->host)
+			return do_get_mem_long((uae_u32*)(h->host + (addr & mmu030.translation.page.mask)));
+		return phys_get_long(h->physical + (addr & mmu030.translation.page.mask));
+	}
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,false)) || (fc==7)) {
@@ -1963,15 +2081,21 @@ uae_u32 mmu030_get_long(uaecptr addr, uae_u32 fc) {
     
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
-    if (atc_line_num>=0) {
-        return mmu030_get_long_atc(addr, atc_line_num, fc);
-    } else {
+    if (atc_line_num<0) {
         mmu030_table_search(addr, fc, false, 0);
-        return mmu030_get_long_atc(addr, mmu030_logical_is_in_atc(addr,fc,false), fc);
+        atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
     }
+    mmu030_hash_add(addr, fc, 0, atc_line_num);
+    return mmu030_get_long_atc(addr, atc_line_num, fc);
 }
 
 uae_u16 mmu030_get_iword(uaecptr addr, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 0);
+	if (h) {
+		if (h->host && mmu030_ifetch_direct)
+			return do_get_mem_word((uae_u16*)(h->host + (addr & mmu030.translation.page.mask)));
+		return x_phys_get_iword(h->physical + (addr & mmu030.translation.page.mask));
+	}
 
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr, fc, false)) || (fc == 7)) {
@@ -1980,14 +2104,20 @@ uae_u16 mmu030_get_iword(uaecptr addr, uae_u32 fc) {
 
 	int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
-	if (atc_line_num >= 0) {
-		return mmu030_get_iword_atc(addr, atc_line_num, fc);
-	} else {
+	if (atc_line_num < 0) {
 		mmu030_table_search(addr, fc, false, 0);
-		return mmu030_get_iword_atc(addr, mmu030_logical_is_in_atc(addr, fc, false), fc);
+		atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 	}
+	mmu030_hash_add(addr, fc, 0, atc_line_num);
+	return mmu030_get_iword_atc(addr, atc_line_num, fc);
 }
 uae_u16 mmu030_get_word(uaecptr addr, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 0);
+	if (h) {
+		if (h->host)
+			return do_get_mem_word((uae_u16*)(h->host + (addr & mmu030.translation.page.mask)));
+		return phys_get_word(h->physical + (addr & mmu030.translation.page.mask));
+	}
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,false)) || (fc==7)) {
@@ -1996,15 +2126,21 @@ uae_u16 mmu030_get_word(uaecptr addr, uae_u32 fc) {
     
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
-    if (atc_line_num>=0) {
-        return mmu030_get_word_atc(addr, atc_line_num, fc);
-    } else {
+    if (atc_line_num<0) {
         mmu030_table_search(addr, fc, false, 0);
-        return mmu030_get_word_atc(addr, mmu030_logical_is_in_atc(addr,fc,false), fc);
+        atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
     }
+    mmu030_hash_add(addr, fc, 0, atc_line_num);
+    return mmu030_get_word_atc(addr, atc_line_num, fc);
 }
 
 uae_u8 mmu030_get_byte(uaecptr addr, uae_u32 fc) {
+	MMU030_ATC_HASH *h = mmu030_hash_lookup(addr, fc, 0);
+	if (h) {
+		if (h->host)
+			return h->host[addr & mmu030.translation.page.mask];
+		return phys_get_byte(h->physical + (addr & mmu030.translation.page.mask));
+	}
     
 	//                                        addr,super,write
 	if ((!mmu030.enabled) || (mmu030_match_ttr_access(addr,fc,false)) || (fc==7)) {
@@ -2013,12 +2149,12 @@ uae_u8 mmu030_get_byte(uaecptr addr, uae_u32 fc) {
     
     int atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
 
-    if (atc_line_num>=0) {
-        return mmu030_get_byte_atc(addr, atc_line_num, fc);
-    } else {
+    if (atc_line_num<0) {
         mmu030_table_search(addr, fc, false, 0);
-        return mmu030_get_byte_atc(addr, mmu030_logical_is_in_atc(addr,fc,false), fc);
+        atc_line_num = mmu030_logical_is_in_atc(addr, fc, false);
     }
+    mmu030_hash_add(addr, fc, 0, atc_line_num);
+    return mmu030_get_byte_atc(addr, atc_line_num, fc);
 }
 
 
@@ -2312,6 +2448,7 @@ void mmu030_reset(int hardreset)
         mmusr_030 = 0;
         mmu030_flush_atc_all();
 	}
+	mmu030_flush_atc_hash();
 	mmu030_set_funcs();
 }
 
@@ -2322,9 +2459,11 @@ void mmu030_set_funcs(void)
 	if (currprefs.cpu_cycle_exact || currprefs.cpu_compatible) {
 		x_phys_get_iword = get_word_icache030;
 		x_phys_get_ilong = get_long_icache030;
+		mmu030_ifetch_direct = false;
 	} else {
 		x_phys_get_iword = phys_get_word;
 		x_phys_get_ilong = phys_get_long;
+		mmu030_ifetch_direct = true;
 	}
 }
 
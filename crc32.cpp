@@ -4,48 +4,74 @@
 
 #include "crc32.h"
 
-static unsigned long crc_table32[256];
+/* crc_table32[0] is the usual bytewise table, [1] to [7] are for
+ * slicing-by-8. Tables are built during static initialization, before
+ * any thread (ROM scanner) exists, so they are read-only afterwards. */
+static uae_u32 crc_table32[8][256];
 static unsigned short crc_table16[256];
+static bool crc_table_ready;
 static void make_crc_table (void)
 {
-	unsigned long c;
+	uae_u32 c;
 	unsigned short w;
 	int n, k;
 	for (n = 0; n < 256; n++) {
-		c = (unsigned long)n;
+		c = (uae_u32)n;
 		w = n << 8;
 		for (k = 0; k < 8; k++) {
 			c = (c >> 1) ^ (c & 1 ? 0xedb88320 : 0);
 			w = (w << 1) ^ ((w & 0x8000) ? 0x1021 : 0);
 		}
-		crc_table32[n] = c;
+		crc_table32[0][n] = c;
 		crc_table16[n] = w;
 	}
+	for (n = 0; n < 256; n++) {
+		c = crc_table32[0][n];
+		for (k = 1; k < 8; k++) {
+			c = crc_table32[0][c & 0xff] ^ (c >> 8);
+			crc_table32[k][n] = c;
+		}
+	}
+	crc_table_ready = true;
 }
+static struct crc_table_init
+{
+	crc_table_init (void) { if (!crc_table_ready) make_crc_table (); }
+} crc_table_init_done;
 uae_u32 get_crc32_val (uae_u8 v, uae_u32 crc)
 {
-	if (!crc_table32[1])
+	if (!crc_table_ready)
 		make_crc_table();
 	crc ^= 0xffffffff;
-	crc = crc_table32[(crc ^ v) & 0xff] ^ (crc >> 8);
+	crc = crc_table32[0][(crc ^ v) & 0xff] ^ (crc >> 8);
 	return crc ^ 0xffffffff;
 }
 uae_u32 get_crc32 (void *vbuf, int len)
 {
 	uae_u8 *buf = (uae_u8*)vbuf;
 	uae_u32 crc;
-	if (!crc_table32[1])
+	if (!crc_table_ready)
 		make_crc_table();
 	crc = 0xffffffff;
+	while (len >= 8) {
+		uae_u32 one = crc ^ (buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uae_u32)buf[3] << 24));
+		uae_u32 two = buf[4] | (buf[5] << 8) | (buf[6] << 16) | ((uae_u32)buf[7] << 24);
+		crc = crc_table32[7][one & 0xff] ^ crc_table32[6][(one >> 8) & 0xff] ^
+			crc_table32[5][(one >> 16) & 0xff] ^ crc_table32[4][one >> 24] ^
+			crc_table32[3][two & 0xff] ^ crc_table32[2][(two >> 8) & 0xff] ^
+			crc_table32[1][(two >> 16) & 0xff] ^ crc_table32[0][two >> 24];
+		buf += 8;
+		len -= 8;
+	}
 	while (len-- > 0)
-		crc = crc_table32[(crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
+		crc = crc_table32[0][(crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
 	return crc ^ 0xffffffff;
 }
 uae_u16 get_crc16 (void *vbuf, int len)
 {
 	uae_u8 *buf = (uae_u8*)vbuf;
 	uae_u16 crc;
-	if (!crc_table32[1])
+	if (!crc_table_ready)
 		make_crc_table();
 	crc = 0xffff;
 	while (len-- > 0)
@@ -56,10 +82,10 @@ uae_u16 get_crc16 (void *vbuf, int len)
 #ifndef GET_UINT32_BE
 #define GET_UINT32_BE(n,b,i)                            \
 {                                                       \
-	(n) = ( (unsigned long) (b)[(i)    ] << 24 )        \
-	| ( (unsigned long) (b)[(i) + 1] << 16 )        \
-	| ( (unsigned long) (b)[(i) + 2] <<  8 )        \
-	| ( (unsigned long) (b)[(i) + 3]       );       \
+	(n) = ( (uae_u32) (b)[(i)    ] << 24 )        \
+	| ( (uae_u32) (b)[(i) + 1] << 16 )        \
+	| ( (uae_u32) (b)[(i) + 2] <<  8 )        \
+	| ( (uae_u32) (b)[(i) + 3]       );       \
 }
 #endif
 #ifndef PUT_UINT32_BE
@@ -74,8 +100,8 @@ uae_u16 get_crc16 (void *vbuf, int len)
 
 typedef struct
 {
-	unsigned long total[2];     /*!< number of bytes processed  */
-	unsigned long state[5];     /*!< intermediate digest state  */
+	uae_u32 total[2];     /*!< number of bytes processed  */
+	uae_u32 state[5];     /*!< intermediate digest state  */
 	unsigned char buffer[64];   /*!< data block being processed */
 }
 sha1_context;
@@ -94,7 +120,7 @@ static void sha1_starts( sha1_context *ctx )
 
 static void sha1_process( sha1_context *ctx, unsigned char data[64] )
 {
-	unsigned long temp, W[16], A, B, C, D, E;
+	uae_u32 temp, W[16], A, B, C, D, E;
 
 	GET_UINT32_BE( W[0],  data,  0 );
 	GET_UINT32_BE( W[1],  data,  4 );
@@ -113,7 +139,7 @@ static void sha1_process( sha1_context *ctx, unsigned char data[64] )
 	GET_UINT32_BE( W[14], data, 56 );
 	GET_UINT32_BE( W[15], data, 60 );
 
-#define S(x,n) ((x << n) | ((x & 0xFFFFFFFF) >> (32 - n)))
+#define S(x,n) ((x << n) | (x >> (32 - n)))
 
 #define R(t)                                            \
 	(                                                       \
@@ -254,7 +280,7 @@ static void sha1_process( sha1_context *ctx, unsigned char data[64] )
 static void sha1_update( sha1_context *ctx, unsigned char *input, int ilen )
 {
 	int fill;
-	unsigned long left;
+	uae_u32 left;
 
 	if( ilen <= 0 )
 		return;
@@ -265,7 +291,7 @@ static void sha1_update( sha1_context *ctx, unsigned char *input, int ilen )
 	ctx->total[0] += ilen;
 	ctx->total[0] &= 0xFFFFFFFF;
 
-	if( ctx->total[0] < (unsigned long) ilen )
+	if( ctx->total[0] < (uae_u32) ilen )
 		ctx->total[1]++;
 
 	if( left && ilen >= fill )
@@ -305,8 +331,8 @@ static const unsigned char sha1_padding[64] =
 */
 static void sha1_finish( sha1_context *ctx, unsigned char output[20] )
 {
-	unsigned long last, padn;
-	unsigned long high, low;
+	uae_u32 last, padn;
+	uae_u32 high, low;
 	unsigned char msglen[8];
 
 	high = ( ctx->total[0] >> 29 )
@@ -114,7 +114,9 @@ static int extra_cycle;
 
 static int rpt_did_reset;
 struct ev eventtab[ev_max];
-struct ev2 eventtab2[ev2_max];
+struct ev2 eventtab2_static[ev2_initial];
+struct ev2 *eventtab2 = eventtab2_static;
+int ev2_max = ev2_initial;
 
 int hpos_offset;
 int vpos;
@@ -6827,6 +6829,62 @@ static int mavg (struct mavg_data *md, int newval, int size)
 
 #define MAVG_VSYNC_SIZE 128
 
+/* headless warp or benchmark: no host pacing, no presentation */
+static bool frame_unbound (void)
+{
+	return currprefs.benchmark_frames > 0 || (currprefs.headless && currprefs.turbo_emulation);
+}
+
+static struct benchmark_data
+{
+	int frames;
+	frame_time_t start;
+	frame_time_t drawtime;
+	frame_time_t rtgtime;
+	unsigned long lastcycles;
+	uae_u64 cycles;
+} benchmark;
+
+static void benchmark_vsync (frame_time_t drawtime, frame_time_t rtgtime)
+{
+	struct benchmark_data *b = &benchmark;
+	frame_time_t now = read_processor_time ();
+	unsigned long c = get_cycles ();
+
+	if (currprefs.benchmark_frames <= 0)
+		return;
+	if (b->frames == 0) {
+		// first frame includes startup, start counting from here
+		memset (b, 0, sizeof (struct benchmark_data));
+		b->start = now;
+		b->lastcycles = c;
+		b->frames = 1;
+		return;
+	}
+	b->cycles += c - b->lastcycles;
+	b->lastcycles = c;
+	b->drawtime += drawtime;
+	b->rtgtime += rtgtime;
+	if (b->frames++ < currprefs.benchmark_frames)
+		return;
+
+	double secs = (double)(now - b->start) / syncbase;
+	if (secs <= 0)
+		secs = 1.0 / syncbase;
+	double draw = (double)b->drawtime / syncbase;
+	double rtg = (double)b->rtgtime / syncbase;
+	write_log (_T("BENCHMARK: %d frames in %.3fs, %.2f frames/s (%.2fx realtime)\n"),
+		currprefs.benchmark_frames, secs, currprefs.benchmark_frames / secs,
+		currprefs.benchmark_frames / secs / vblank_hz);
+	write_log (_T("BENCHMARK: %.0f cycles/s, emulation %.3fs (%.1f%%), drawing %.3fs (%.1f%%), rtg %.3fs (%.1f%%)\n"),
+		(double)(b->cycles / CYCLE_UNIT) / secs,
+		secs - draw - rtg, (secs - draw - rtg) * 100.0 / secs,
+		draw, draw * 100.0 / secs, rtg, rtg * 100.0 / secs);
+	b->frames = 0;
+	changed_prefs.benchmark_frames = currprefs.benchmark_frames = 0;
+	uae_quit ();
+}
+
 extern int log_vsync, debug_vsync_min_delay, debug_vsync_forced_delay;
 static bool framewait (void)
 {
@@ -6842,6 +6900,14 @@ static bool framewait (void)
 
 	frameskiptime = 0;
 
+	if (frame_unbound ()) {
+		curr_time = read_processor_time ();
+		vsyncmintime = curr_time;
+		vsyncmaxtime = vsyncwaittime = curr_time + vsynctimebase;
+		vsynctimeperline = 0;
+		return true;
+	}
+
 	if (vs > 0) {
 
 		static struct mavg_data ma_legacy;
@@ -7231,9 +7297,13 @@ static void vsync_handler_pre (void)
 		timehack_alive--;
 
 	devices_vsync_pre();
+	frame_time_t rtgtime = 0, drawtime = 0;
 #ifdef PICASSO96
-	if (isvsync_rtg () >= 0)
+	if (isvsync_rtg () >= 0) {
+		rtgtime = frameskiptime;
 		rtg_vsync ();
+		rtgtime = frameskiptime - rtgtime;
+	}
 #endif
 
 	if (!vsync_rendered) {
@@ -7243,11 +7313,12 @@ static void vsync_handler_pre (void)
 		vsync_rendered = true;
 		end = read_processor_time ();
 		frameskiptime += end - start;
+		drawtime = end - start;
 	}
 
 	bool frameok = framewait ();
 	
-	if (!picasso_on) {
+	if (!picasso_on && !frame_unbound ()) {
 		if (!frame_rendered && vblank_hz_state) {
 			frame_rendered = render_screen (false);
 		}
@@ -7257,6 +7328,7 @@ static void vsync_handler_pre (void)
 	}
 
 	fpscounter (frameok);
+	benchmark_vsync (drawtime, rtgtime);
 
 	vsync_rendered = false;
 	frame_shown = false;
@@ -7812,7 +7884,10 @@ static void hsync_handler_post (bool onvsync)
 		port_get_custom (1, out);
 	}
 #endif
-	if (currprefs.m68k_speed < 0 && !currprefs.cpu_cycle_exact) {
+	if (frame_unbound ()) {
+		/* never wait for host time */
+		is_syncline = 0;
+	} else if (currprefs.m68k_speed < 0 && !currprefs.cpu_cycle_exact) {
 		static int sleeps_remaining;
 		if (is_last_line ()) {
 			sleeps_remaining = (165 - currprefs.cpu_idle) / 6;
@@ -8007,7 +8082,7 @@ static void hsync_handler_post (bool onvsync)
 		start = read_processor_time ();
 		vsync_rendered = true;
 		vsync_handle_redraw (lof_store, lof_changed, bplcon0, bplcon3);
-		if (vblank_hz_state) {
+		if (vblank_hz_state && !frame_unbound ()) {
 			frame_rendered = render_screen (true);
 		}
 		end = read_processor_time ();
@@ -8053,9 +8128,7 @@ void init_eventtab (void)
 		eventtab[i].active = 0;
 		eventtab[i].oldcycles = get_cycles ();
 	}
-	for (i = 0; i < ev2_max; i++) {
-		eventtab2[i].active = 0;
-	}
+	event2_clear ();
 
 	eventtab[ev_cia].handler = CIA_handler;
 	eventtab[ev_hsync].handler = hsync_handler;
@@ -9369,9 +9442,10 @@ uae_u8 *save_custom_extra (int *len, uae_u8 *dstptr)
 
 uae_u8 *restore_custom_event_delay (uae_u8 *src)
 {
-	if (restore_u32 () != 1)
+	uae_u32 ver = restore_u32 ();
+	if (ver != 1 && ver != 2)
 		return src;
-	int cnt = restore_u8 ();
+	int cnt = ver == 1 ? restore_u8 () : restore_u32 ();
 	for (int i = 0; i < cnt; i++) {
 		uae_u8 type = restore_u8 ();
 		evt e = restore_u64 ();
@@ -9398,10 +9472,10 @@ uae_u8 *save_custom_event_delay (int *len, uae_u8 *dstptr)
 	if (dstptr)
 		dstbak = dst = dstptr;
 	else
-		dstbak = dst = xmalloc (uae_u8, 1000);
+		dstbak = dst = xmalloc (uae_u8, 4 + 4 + cnt * (1 + 8 + 4));
 
-	save_u32 (1);
-	save_u8 (cnt);
+	save_u32 (2);
+	save_u32 (cnt);
 	for (int i = ev2_misc; i < ev2_max; i++) {
 		struct ev2 *e = &eventtab2[i];
 		if (e->active && e->handler == send_interrupt_do) {
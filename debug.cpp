@@ -2484,6 +2484,7 @@ static void memwatch_remap (uaecptr addr)
 		newbank->wgeti = mode ? mmu_wgeti : debug_wgeti;
 		newbank->lgeti = mode ? mmu_lgeti : debug_lgeti;
 		newbank->name = my_strdup (tmp);
+		newbank->flags &= ~ABFLAG_DIRECTACCESS;
 		if (!newbank->mask)
 			newbank->mask = -1;
 	}
@@ -40,6 +40,7 @@
 #include "blitter.h"
 #include "xwin.h"
 #include "custom.h"
+#include "drawing.h"
 #include "serial.h"
 #include "bsdsocket.h"
 #include "uaeserial.h"
@@ -259,6 +260,7 @@ void do_leave_program (void)
 {
 	sampler_free ();
 	graphics_leave ();
+	drawing_free ();
 	inputdevice_close ();
 	DISK_free ();
 	close_sound ();
@@ -56,6 +56,7 @@ int disk_debug_track = -1;
 #include "fsdb.h"
 #include "statusline.h"
 #include "rommgr.h"
+#include "threaddep/thread.h"
 
 #undef CATWEASEL
 
@@ -214,6 +215,7 @@ typedef struct {
 	int lastrev;
 	bool track_access_done;
 #endif
+	struct mfmcache *cache;
 } drive;
 
 #define MIN_STEPLIMIT_CYCLE (CYCLE_UNIT * 140)
@@ -617,8 +619,12 @@ static void drive_settype_id (drive *drv)
 #endif
 }
 
+static void mfmcache_init (drive *drv);
+static void mfmcache_free (drive *drv);
+
 static void drive_image_free (drive *drv)
 {
+	mfmcache_free (drv);
 	switch (drv->filetype)
 	{
 	case ADF_IPF:
@@ -1345,6 +1351,8 @@ static int drive_insert (drive * drv, struct uae_prefs *p, int dnum, const TCHAR
 	}
 	openwritefile (p, drv, 0);
 	drive_settype_id (drv); /* Set DD or HD drive */
+	if (!fake)
+		mfmcache_init (drv);
 	drive_fill_bigbuf (drv, 1);
 	drv->mfmpos = uaerand ();
 	drv->mfmpos |= (uaerand () << 16);
@@ -1590,17 +1598,42 @@ static uae_u16 *mfmcoder (uae_u8 *src, uae_u16 *dest, int len)
 	return dest;
 }
 
-static void decode_pcdos (drive *drv)
+/* Encoded track output, and where the encoder reads sector data from:
+ * the image file or, for the background cache, an in-memory copy of it. */
+struct trackbuf {
+	uae_u16 *mfm;
+	int tracklen;
+	int skipoffset;
+	const uae_u8 *image;
+	int imagesize;
+};
+
+static void read_track_data (drive *drv, struct trackbuf *tb, trackid *ti, int offset, uae_u8 *dst, int len)
+{
+	if (!tb->image) {
+		read_floppy_data (drv->diskfile, drv->filetype, ti, offset, dst, len);
+		return;
+	}
+	int off = ti->offs + offset;
+	int avail = off >= 0 && off < tb->imagesize ? tb->imagesize - off : 0;
+	if (avail > len)
+		avail = len;
+	if (avail > 0)
+		memcpy (dst, tb->image + off, avail);
+	if (avail < len)
+		memset (dst + avail, 0, len - avail);
+}
+
+static void decode_pcdos (drive *drv, int tr, struct trackbuf *tb)
 {
 	int i, len;
-	int tr = drv->cyl * 2 + side;
 	uae_u16 *dstmfmbuf, *mfm2;
 	uae_u8 secbuf[1000];
 	uae_u16 crc16;
 	trackid *ti = drv->trackdata + tr;
 	int tracklen = 12500;
 
-	mfm2 = drv->bigmfmbuf;
+	mfm2 = tb->mfm;
 	*mfm2++ = 0x9254;
 	memset (secbuf, 0x4e, 40);
 	memset (secbuf + 40, 0x00, 12);
@@ -1620,8 +1653,8 @@ static void decode_pcdos (drive *drv)
 		secbuf[13] = 0xa1;
 		secbuf[14] = 0xa1;
 		secbuf[15] = 0xfe;
-		secbuf[16] = drv->cyl;
-		secbuf[17] = side;
+		secbuf[16] = tr / 2;
+		secbuf[17] = tr & 1;
 		secbuf[18] = 1 + i;
 		secbuf[19] = 2; // 128 << 2 = 512
 		crc16 = get_crc16(secbuf + 12, 3 + 1 + 4);
@@ -1633,7 +1666,7 @@ static void decode_pcdos (drive *drv)
 		secbuf[57] = 0xa1;
 		secbuf[58] = 0xa1;
 		secbuf[59] = 0xfb;
-		read_floppy_data (drv->diskfile, drv->filetype, ti, i * 512, &secbuf[60], 512);
+		read_track_data (drv, tb, ti, i * 512, &secbuf[60], 512);
 		crc16 = get_crc16 (secbuf + 56, 3 + 1 + 512);
 		secbuf[60 + 512] = crc16 >> 8;
 		secbuf[61 + 512] = crc16 & 0xff;
@@ -1648,29 +1681,28 @@ static void decode_pcdos (drive *drv)
 		mfm2[57] = 0x4489;
 		mfm2[58] = 0x4489;
 	}
-	while (dstmfmbuf - drv->bigmfmbuf < tracklen / 2)
+	while (dstmfmbuf - tb->mfm < tracklen / 2)
 		*dstmfmbuf++ = 0x9254;
-	drv->skipoffset = 0;
-	drv->tracklen = (dstmfmbuf - drv->bigmfmbuf) * 16;
+	tb->skipoffset = 0;
+	tb->tracklen = (dstmfmbuf - tb->mfm) * 16;
 	if (disk_debug_logging > 0)
 		write_log (_T("pcdos read track %d\n"), tr);
 }
 
-static void decode_amigados (drive *drv)
+static void decode_amigados (drive *drv, int tr, struct trackbuf *tb)
 {
 	/* Normal AmigaDOS format track */
-	int tr = drv->cyl * 2 + side;
 	int sec;
 	int dstmfmoffset = 0;
-	uae_u16 *dstmfmbuf = drv->bigmfmbuf;
+	uae_u16 *dstmfmbuf = tb->mfm;
 	int len = drv->num_secs * 544 + FLOPPY_GAP_LEN;
 	int prevbit;
 
 	trackid *ti = drv->trackdata + tr;
 	memset (dstmfmbuf, 0xaa, len * 2);
 	dstmfmoffset += FLOPPY_GAP_LEN;
-	drv->skipoffset = (FLOPPY_GAP_LEN * 8) / 3 * 2;
-	drv->tracklen = len * 2 * 8;
+	tb->skipoffset = (FLOPPY_GAP_LEN * 8) / 3 * 2;
+	tb->tracklen = len * 2 * 8;
 
 	prevbit = 0;
 	for (sec = 0; sec < drv->num_secs; sec++) {
@@ -1690,7 +1722,7 @@ static void decode_amigados (drive *drv)
 		for (i = 8; i < 24; i++)
 			secbuf[i] = 0;
 
-		read_floppy_data (drv->diskfile, drv->filetype, ti, sec * 512, &secbuf[32], 512);
+		read_track_data (drv, tb, ti, sec * 512, &secbuf[32], 512);
 
 		mfmbuf[0] = prevbit ? 0x2aaa : 0xaaaa;
 		mfmbuf[1] = 0xaaaa;
@@ -1769,20 +1801,19 @@ static void decode_amigados (drive *drv)
 *
 */
 
-static void decode_diskspare (drive *drv)
+static void decode_diskspare (drive *drv, int tr, struct trackbuf *tb)
 {
-	int tr = drv->cyl * 2 + side;
 	int sec;
 	int dstmfmoffset = 0;
 	int size = 512 + 8;
-	uae_u16 *dstmfmbuf = drv->bigmfmbuf;
+	uae_u16 *dstmfmbuf = tb->mfm;
 	int len = drv->num_secs * size + FLOPPY_GAP_LEN;
 
 	trackid *ti = drv->trackdata + tr;
 	memset (dstmfmbuf, 0xaa, len * 2);
 	dstmfmoffset += FLOPPY_GAP_LEN;
-	drv->skipoffset = (FLOPPY_GAP_LEN * 8) / 3 * 2;
-	drv->tracklen = len * 2 * 8;
+	tb->skipoffset = (FLOPPY_GAP_LEN * 8) / 3 * 2;
+	tb->tracklen = len * 2 * 8;
 
 	for (sec = 0; sec < drv->num_secs; sec++) {
 		uae_u8 secbuf[512 + 8];
@@ -1796,7 +1827,7 @@ static void decode_diskspare (drive *drv)
 		secbuf[2] = 0;
 		secbuf[3] = 0;
 
-		read_floppy_data (drv->diskfile, drv->filetype, ti, sec * 512, &secbuf[4], 512);
+		read_track_data (drv, tb, ti, sec * 512, &secbuf[4], 512);
 
 		mfmbuf[0] = 0xaaaa;
 		mfmbuf[1] = 0x4489;
@@ -1845,6 +1876,193 @@ static void decode_diskspare (drive *drv)
 		write_log (_T("diskspare read track %d\n"), tr);
 }
 
+static bool encode_track (drive *drv, int tr, struct trackbuf *tb)
+{
+	switch (drv->trackdata[tr].type)
+	{
+	case TRACK_PCDOS:
+		decode_pcdos (drv, tr, tb);
+		return true;
+	case TRACK_AMIGADOS:
+		decode_amigados (drv, tr, tb);
+		return true;
+	case TRACK_DISKSPARE:
+		decode_diskspare (drv, tr, tb);
+		return true;
+	}
+	return false;
+}
+
+/*
+* Encoded track cache
+*
+* Sector based images (ADF, PC, DiskSpare and the sector tracks of
+* extended ADF) are encoded once per track. A worker thread encodes the
+* whole image from an in-memory copy after insertion, tracks it hasn't
+* reached yet are encoded on demand and stored by the emulation thread.
+* Writes invalidate the track, it is re-encoded from the image file the
+* next time it is needed.
+*/
+
+#define MFMCACHE_MAX_IMAGE (4 * 1024 * 1024)
+
+enum { MFMCACHE_PENDING, MFMCACHE_VALID, MFMCACHE_DIRTY };
+
+struct mfmcache_track {
+	uae_u16 *mfm;
+	int tracklen;
+	int skipoffset;
+	int state;
+};
+
+struct mfmcache {
+	struct mfmcache_track tracks[MAX_TRACKS];
+	uae_sem_t lock;
+	uae_thread_id tid;
+	bool thread;
+	volatile bool abort;
+	uae_u8 *image;
+	int imagesize;
+	drive *drv;
+};
+
+static bool mfmcache_supported (drive *drv)
+{
+	return drv->filetype == ADF_NORMAL || drv->filetype == ADF_EXT1 || drv->filetype == ADF_EXT2 || drv->filetype == ADF_PCDOS;
+}
+
+/* called with the lock held */
+static void mfmcache_store (struct mfmcache *c, int tr, struct trackbuf *tb)
+{
+	struct mfmcache_track *t = &c->tracks[tr];
+	int words = (tb->tracklen + 15) / 16;
+
+	xfree (t->mfm);
+	t->mfm = xmalloc (uae_u16, words);
+	if (!t->mfm) {
+		t->state = MFMCACHE_DIRTY;
+		return;
+	}
+	memcpy (t->mfm, tb->mfm, words * sizeof (uae_u16));
+	t->tracklen = tb->tracklen;
+	t->skipoffset = tb->skipoffset;
+	t->state = MFMCACHE_VALID;
+}
+
+static void *mfmcache_thread (void *v)
+{
+	struct mfmcache *c = (struct mfmcache*)v;
+	drive *drv = c->drv;
+	uae_u16 *mfm = xmalloc (uae_u16, 0x4000 * DDHDMULT);
+	int cnt = 0;
+
+	for (int tr = 0; mfm && tr < drv->num_tracks && tr < MAX_TRACKS && !c->abort; tr++) {
+		struct trackbuf tb = { 0 };
+		tb.mfm = mfm;
+		tb.image = c->image;
+		tb.imagesize = c->imagesize;
+		if (c->tracks[tr].state != MFMCACHE_PENDING)
+			continue;
+		if (!encode_track (drv, tr, &tb))
+			continue;
+		uae_sem_wait (&c->lock);
+		if (c->tracks[tr].state == MFMCACHE_PENDING) {
+			mfmcache_store (c, tr, &tb);
+			cnt++;
+		}
+		uae_sem_post (&c->lock);
+	}
+	xfree (mfm);
+	if (disk_debug_logging > 0)
+		write_log (_T("DF%d: %d tracks cached\n"), drv - floppy, cnt);
+	return NULL;
+}
+
+static void mfmcache_free (drive *drv)
+{
+	struct mfmcache *c = drv->cache;
+
+	if (!c)
+		return;
+	if (c->thread) {
+		c->abort = true;
+		uae_wait_thread (c->tid);
+	}
+	for (int i = 0; i < MAX_TRACKS; i++)
+		xfree (c->tracks[i].mfm);
+	xfree (c->image);
+	uae_sem_destroy (&c->lock);
+	xfree (c);
+	drv->cache = NULL;
+}
+
+static void mfmcache_init (drive *drv)
+{
+	struct mfmcache *c;
+	uae_s64 size;
+
+	mfmcache_free (drv);
+	if (!drv->diskfile || !mfmcache_supported (drv))
+		return;
+	c = xcalloc (struct mfmcache, 1);
+	if (!c)
+		return;
+	c->drv = drv;
+	uae_sem_init (&c->lock, 0, 1);
+	drv->cache = c;
+	size = zfile_size (drv->diskfile);
+	if (size <= 0 || size > MFMCACHE_MAX_IMAGE)
+		return;
+	c->image = zfile_getdata (drv->diskfile, 0, (int)size);
+	if (!c->image)
+		return;
+	c->imagesize = (int)size;
+	c->thread = uae_start_thread (NULL, mfmcache_thread, c, &c->tid) != 0;
+}
+
+static bool mfmcache_get (drive *drv, int tr)
+{
+	struct mfmcache *c = drv->cache;
+	bool hit = false;
+
+	if (!c)
+		return false;
+	uae_sem_wait (&c->lock);
+	struct mfmcache_track *t = &c->tracks[tr];
+	if (t->state == MFMCACHE_VALID) {
+		memcpy (drv->bigmfmbuf, t->mfm, ((t->tracklen + 15) / 16) * sizeof (uae_u16));
+		drv->tracklen = t->tracklen;
+		drv->skipoffset = t->skipoffset;
+		hit = true;
+	}
+	uae_sem_post (&c->lock);
+	return hit;
+}
+
+static void mfmcache_put (drive *drv, int tr, struct trackbuf *tb)
+{
+	struct mfmcache *c = drv->cache;
+
+	if (!c)
+		return;
+	uae_sem_wait (&c->lock);
+	mfmcache_store (c, tr, tb);
+	uae_sem_post (&c->lock);
+}
+
+static void mfmcache_invalidate (drive *drv, int tr)
+{
+	struct mfmcache *c = drv->cache;
+
+	if (!c || tr < 0 || tr >= MAX_TRACKS)
+		return;
+	uae_sem_wait (&c->lock);
+	xfree (c->tracks[tr].mfm);
+	c->tracks[tr].mfm = NULL;
+	c->tracks[tr].state = MFMCACHE_DIRTY;
+	uae_sem_post (&c->lock);
+}
+
 static void drive_fill_bigbuf (drive * drv, int force)
 {
 	int tr = drv->cyl * 2 + side;
@@ -1917,17 +2135,16 @@ static void drive_fill_bigbuf (drive * drv, int force)
 		fdi2raw_loadtrack (drv->fdi, drv->bigmfmbuf, drv->tracktiming, tr, &drv->tracklen, &drv->indexoffset, &drv->multi_revolution, 1);
 #endif
 
-	} else if (ti->type == TRACK_PCDOS) {
+	} else if (ti->type == TRACK_PCDOS || ti->type == TRACK_AMIGADOS || ti->type == TRACK_DISKSPARE) {
 
-		decode_pcdos (drv);
-
-	} else if (ti->type == TRACK_AMIGADOS) {
-
-		decode_amigados (drv);
-
-	} else if (ti->type == TRACK_DISKSPARE) {
-
-		decode_diskspare (drv);
+		if (!mfmcache_get (drv, tr)) {
+			struct trackbuf tb = { 0 };
+			tb.mfm = drv->bigmfmbuf;
+			encode_track (drv, tr, &tb);
+			drv->tracklen = tb.tracklen;
+			drv->skipoffset = tb.skipoffset;
+			mfmcache_put (drv, tr, &tb);
+		}
 
 	} else if (ti->type == TRACK_NONE) {
 
@@ -2335,11 +2552,13 @@ static bool convert_adf_to_ext2 (drive *drv, int mode)
 		return false;
 	_tcscpy (currprefs.floppyslots[drv - floppy].df, name);
 	_tcscpy (changed_prefs.floppyslots[drv - floppy].df, name);
+	mfmcache_free (drv);
 	zfile_fclose (drv->diskfile);
 
 	drv->diskfile = f;
 	drv->filetype = ADF_EXT2;
 	read_header_ext2 (drv->diskfile, drv->trackdata, &drv->num_tracks, &drv->ddhd);
+	mfmcache_init (drv);
 
 	drive_write_data (drv);
 #ifdef RETROPLATFORM
@@ -2355,6 +2574,7 @@ static void drive_write_data (drive * drv)
 	int ret = -1;
 	int tr = drv->cyl * 2 + side;
 
+	mfmcache_invalidate (drv, tr);
 	if (drive_writeprotected (drv) || drv->trackdata[tr].type == TRACK_NONE) {
 		/* read original track back because we didn't really write anything */
 		drv->buffered_side = 2;
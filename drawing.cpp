@@ -51,6 +51,8 @@ happening, all ports should restrict window widths to be multiples of 16 pixels.
 #include "debug.h"
 #include "cd32_fmv.h"
 
+#include "p2c.h"
+
 extern bool emulate_specialmonitors (struct vidbuffer*, struct vidbuffer*);
 
 extern int sprite_buffer_res;
@@ -1958,117 +1960,247 @@ static void weird_bitplane_fix (int start, int end)
 
 /* We use the compiler's inlining ability to ensure that PLANES is in effect a compile time
 constant.  That will cause some unnecessary code to be optimized away.
-Don't touch this if you don't know what you are doing.  */
-
-#define MERGE(a,b,mask,shift) do {\
-	uae_u32 tmp = mask & (a ^ (b >> shift)); \
-	a ^= tmp; \
-	b ^= (tmp << shift); \
-} while (0)
+Don't touch this if you don't know what you are doing.  The inlined kernels are in
+p2c.h, these functions should _not_ be inlined themselves.  */
+static void NOINLINE pfield_doline_n1 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 1, bplpt); }
+static void NOINLINE pfield_doline_n2 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 2, bplpt); }
+static void NOINLINE pfield_doline_n3 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 3, bplpt); }
+static void NOINLINE pfield_doline_n4 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 4, bplpt); }
+static void NOINLINE pfield_doline_n5 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 5, bplpt); }
+static void NOINLINE pfield_doline_n6 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 6, bplpt); }
+#ifdef AGA
+static void NOINLINE pfield_doline_n7 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 7, bplpt); }
+static void NOINLINE pfield_doline_n8 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_1 (data, count, 8, bplpt); }
+#endif
+#ifdef P2C_SSE2
+static void NOINLINE pfield_doline_sse2_n1 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 1, bplpt); }
+static void NOINLINE pfield_doline_sse2_n2 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 2, bplpt); }
+static void NOINLINE pfield_doline_sse2_n3 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 3, bplpt); }
+static void NOINLINE pfield_doline_sse2_n4 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 4, bplpt); }
+static void NOINLINE pfield_doline_sse2_n5 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 5, bplpt); }
+static void NOINLINE pfield_doline_sse2_n6 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 6, bplpt); }
+#ifdef AGA
+static void NOINLINE pfield_doline_sse2_n7 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 7, bplpt); }
+static void NOINLINE pfield_doline_sse2_n8 (uae_u32 *data, int count, uae_u8 **bplpt) { pfield_doline_sse2 (data, count, 8, bplpt); }
+#endif
+#endif
 
-#define GETLONG(P) (*(uae_u32 *)P)
+typedef void (*pfield_doline_func)(uae_u32*, int, uae_u8**);
+static pfield_doline_func pfield_doline_funcs[9];
 
-STATIC_INLINE void pfield_doline_1 (uae_u32 *pixels, int wordcount, int planes)
+static void pfield_doline_init (void)
 {
-	while (wordcount-- > 0) {
-		uae_u32 b0, b1, b2, b3, b4, b5, b6, b7;
-
-		b0 = 0, b1 = 0, b2 = 0, b3 = 0, b4 = 0, b5 = 0, b6 = 0, b7 = 0;
-		switch (planes) {
+	pfield_doline_funcs[1] = pfield_doline_n1;
+	pfield_doline_funcs[2] = pfield_doline_n2;
+	pfield_doline_funcs[3] = pfield_doline_n3;
+	pfield_doline_funcs[4] = pfield_doline_n4;
+	pfield_doline_funcs[5] = pfield_doline_n5;
+	pfield_doline_funcs[6] = pfield_doline_n6;
 #ifdef AGA
-		case 8: b0 = GETLONG (real_bplpt[7]); real_bplpt[7] += 4;
-		case 7: b1 = GETLONG (real_bplpt[6]); real_bplpt[6] += 4;
+	pfield_doline_funcs[7] = pfield_doline_n7;
+	pfield_doline_funcs[8] = pfield_doline_n8;
 #endif
-		case 6: b2 = GETLONG (real_bplpt[5]); real_bplpt[5] += 4;
-		case 5: b3 = GETLONG (real_bplpt[4]); real_bplpt[4] += 4;
-		case 4: b4 = GETLONG (real_bplpt[3]); real_bplpt[3] += 4;
-		case 3: b5 = GETLONG (real_bplpt[2]); real_bplpt[2] += 4;
-		case 2: b6 = GETLONG (real_bplpt[1]); real_bplpt[1] += 4;
-		case 1: b7 = GETLONG (real_bplpt[0]); real_bplpt[0] += 4;
-		}
-
-		MERGE (b0, b1, 0x55555555, 1);
-		MERGE (b2, b3, 0x55555555, 1);
-		MERGE (b4, b5, 0x55555555, 1);
-		MERGE (b6, b7, 0x55555555, 1);
-
-		MERGE (b0, b2, 0x33333333, 2);
-		MERGE (b1, b3, 0x33333333, 2);
-		MERGE (b4, b6, 0x33333333, 2);
-		MERGE (b5, b7, 0x33333333, 2);
-
-		MERGE (b0, b4, 0x0f0f0f0f, 4);
-		MERGE (b1, b5, 0x0f0f0f0f, 4);
-		MERGE (b2, b6, 0x0f0f0f0f, 4);
-		MERGE (b3, b7, 0x0f0f0f0f, 4);
-
-		MERGE (b0, b1, 0x00ff00ff, 8);
-		MERGE (b2, b3, 0x00ff00ff, 8);
-		MERGE (b4, b5, 0x00ff00ff, 8);
-		MERGE (b6, b7, 0x00ff00ff, 8);
-
-		MERGE (b0, b2, 0x0000ffff, 16);
-		do_put_mem_long (pixels, b0);
-		do_put_mem_long (pixels + 4, b2);
-		MERGE (b1, b3, 0x0000ffff, 16);
-		do_put_mem_long (pixels + 2, b1);
-		do_put_mem_long (pixels + 6, b3);
-		MERGE (b4, b6, 0x0000ffff, 16);
-		do_put_mem_long (pixels + 1, b4);
-		do_put_mem_long (pixels + 5, b6);
-		MERGE (b5, b7, 0x0000ffff, 16);
-		do_put_mem_long (pixels + 3, b5);
-		do_put_mem_long (pixels + 7, b7);
-		pixels += 8;
-	}
-}
-
-/* See above for comments on inlining.  These functions should _not_
-be inlined themselves.  */
-static void NOINLINE pfield_doline_n1 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 1); }
-static void NOINLINE pfield_doline_n2 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 2); }
-static void NOINLINE pfield_doline_n3 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 3); }
-static void NOINLINE pfield_doline_n4 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 4); }
-static void NOINLINE pfield_doline_n5 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 5); }
-static void NOINLINE pfield_doline_n6 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 6); }
+#ifdef P2C_SSE2
+	if (p2c_sse2_supported ()) {
+		pfield_doline_funcs[1] = pfield_doline_sse2_n1;
+		pfield_doline_funcs[2] = pfield_doline_sse2_n2;
+		pfield_doline_funcs[3] = pfield_doline_sse2_n3;
+		pfield_doline_funcs[4] = pfield_doline_sse2_n4;
+		pfield_doline_funcs[5] = pfield_doline_sse2_n5;
+		pfield_doline_funcs[6] = pfield_doline_sse2_n6;
 #ifdef AGA
-static void NOINLINE pfield_doline_n7 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 7); }
-static void NOINLINE pfield_doline_n8 (uae_u32 *data, int count) { pfield_doline_1 (data, count, 8); }
+		pfield_doline_funcs[7] = pfield_doline_sse2_n7;
+		pfield_doline_funcs[8] = pfield_doline_sse2_n8;
+#endif
+	}
 #endif
+}
 
-static void pfield_doline (int lineno)
+static void pfield_doline_planes (uae_u32 *data, int lineno, int planes, int wordcount)
 {
-	int wordcount = dp_for_drawing->plflinelen;
-	uae_u32 *data = pixdata.apixels_l + MAX_PIXELS_PER_LINE / 4;
+	uae_u8 *bplpt[8];
 
 #ifdef SMART_UPDATE
 #define DATA_POINTER(n) ((debug_bpl_mask & (1 << n)) ? (line_data[lineno] + (n) * MAX_WORDS_PER_LINE * 2) : (debug_bpl_mask_one ? all_ones : all_zeros))
-	real_bplpt[0] = DATA_POINTER (0);
-	real_bplpt[1] = DATA_POINTER (1);
-	real_bplpt[2] = DATA_POINTER (2);
-	real_bplpt[3] = DATA_POINTER (3);
-	real_bplpt[4] = DATA_POINTER (4);
-	real_bplpt[5] = DATA_POINTER (5);
+	bplpt[0] = DATA_POINTER (0);
+	bplpt[1] = DATA_POINTER (1);
+	bplpt[2] = DATA_POINTER (2);
+	bplpt[3] = DATA_POINTER (3);
+	bplpt[4] = DATA_POINTER (4);
+	bplpt[5] = DATA_POINTER (5);
 #ifdef AGA
-	real_bplpt[6] = DATA_POINTER (6);
-	real_bplpt[7] = DATA_POINTER (7);
+	bplpt[6] = DATA_POINTER (6);
+	bplpt[7] = DATA_POINTER (7);
 #endif
+#else
+	memcpy (bplpt, real_bplpt, sizeof bplpt);
 #endif
 
-	switch (bplplanecnt) {
-	default: break;
-	case 0: memset (data, 0, wordcount * 32); break;
-	case 1: pfield_doline_n1 (data, wordcount); break;
-	case 2: pfield_doline_n2 (data, wordcount); break;
-	case 3: pfield_doline_n3 (data, wordcount); break;
-	case 4: pfield_doline_n4 (data, wordcount); break;
-	case 5: pfield_doline_n5 (data, wordcount); break;
-	case 6: pfield_doline_n6 (data, wordcount); break;
-#ifdef AGA
-	case 7: pfield_doline_n7 (data, wordcount); break;
-	case 8: pfield_doline_n8 (data, wordcount); break;
-#endif
+	if (planes == 0)
+		memset (data, 0, wordcount * 32);
+	else if (planes > 0 && planes <= 8 && pfield_doline_funcs[planes])
+		pfield_doline_funcs[planes] (data, wordcount, bplpt);
+}
+
+/* Bitplane decoding of a whole frame is done before drawing it, split
+between the drawing thread and P2C_WORKERS worker threads. Lines whose
+decisions changed after the prepass (mid-line BPLCON0 writes update
+line_decisions while drawing) are decoded again in pfield_doline().  */
+
+#define P2C_WORKERS 2
+#define P2C_MIN_LINES 64
+#define P2C_LINES ((MAXVPOS + 2) * 2)
+
+struct p2c_line
+{
+	bool valid;
+	int planes;
+	int wordcount;
+	int mask, maskone;
+};
+
+struct p2c_worker
+{
+	uae_sem_t start, done;
+	uae_thread_id tid;
+	int first, last;
+};
+
+static struct p2c_line p2c_lines[P2C_LINES];
+static uae_s16 p2c_jobs[P2C_LINES];
+static uae_u8 *p2c_frame;
+static struct p2c_worker p2c_workers[P2C_WORKERS];
+static bool p2c_threads;
+static volatile bool p2c_quit;
+
+static void p2c_decode (int first, int last)
+{
+	for (int i = first; i < last; i++) {
+		int lineno = p2c_jobs[i];
+		struct p2c_line *pl = &p2c_lines[lineno];
+		pfield_doline_planes ((uae_u32*)(p2c_frame + lineno * MAX_PIXELS_PER_LINE), lineno, pl->planes, pl->wordcount);
+	}
+}
+
+static void *p2c_thread (void *v)
+{
+	struct p2c_worker *w = (struct p2c_worker*)v;
+	for (;;) {
+		uae_sem_wait (&w->start);
+		if (p2c_quit)
+			break;
+		p2c_decode (w->first, w->last);
+		uae_sem_post (&w->done);
+	}
+	return NULL;
+}
+
+static void p2c_init (void)
+{
+	if (p2c_threads)
+		return;
+	p2c_frame = xmalloc (uae_u8, P2C_LINES * MAX_PIXELS_PER_LINE);
+	if (!p2c_frame)
+		return;
+	p2c_quit = false;
+	for (int i = 0; i < P2C_WORKERS; i++) {
+		struct p2c_worker *w = &p2c_workers[i];
+		uae_sem_init (&w->start, 0, 0);
+		uae_sem_init (&w->done, 0, 0);
+		uae_start_thread (_T("p2c"), p2c_thread, w, &w->tid);
 	}
+	p2c_threads = true;
+}
+
+static void p2c_free (void)
+{
+	if (!p2c_threads)
+		return;
+	p2c_quit = true;
+	for (int i = 0; i < P2C_WORKERS; i++) {
+		struct p2c_worker *w = &p2c_workers[i];
+		uae_sem_post (&w->start);
+		uae_wait_thread (w->tid);
+		uae_sem_destroy (&w->start);
+		uae_sem_destroy (&w->done);
+	}
+	p2c_threads = false;
+	memset (p2c_lines, 0, sizeof p2c_lines);
+	xfree (p2c_frame);
+	p2c_frame = NULL;
+}
+
+/* same line selection as draw_frame2() and pfield_draw_line() */
+static void p2c_prepass (struct vidbuffer *vbin)
+{
+	int cnt = 0;
+
+	memset (p2c_lines, 0, sizeof p2c_lines);
+	if (!p2c_threads)
+		return;
+	for (int i = 0; i < max_ypos_thisframe; i++) {
+		int i1 = i + min_ypos_for_screen;
+		int lineno = i + thisframe_y_adjust_real;
+		int whereline = amiga2aspect_line_map[i1];
+		struct decision *dp = line_decisions + lineno;
+
+		if (whereline >= vbin->inheight)
+			break;
+		if (whereline < 0 || lineno < 0 || lineno >= P2C_LINES)
+			continue;
+		switch (linestate[lineno])
+		{
+		case LINE_REMEMBERED_AS_PREVIOUS:
+		case LINE_BLACK:
+		case LINE_REMEMBERED_AS_BLACK:
+		case LINE_DONE_AS_PREVIOUS:
+		case LINE_DONE:
+			continue;
+		case LINE_AS_PREVIOUS:
+			dp--;
+			break;
+		}
+		if (dp->plfleft < 0 || dp->plflinelen * 32 > MAX_PIXELS_PER_LINE)
+			continue;
+		struct p2c_line *pl = &p2c_lines[lineno];
+		pl->planes = dp->nr_planes;
+		pl->wordcount = dp->plflinelen;
+		pl->mask = debug_bpl_mask;
+		pl->maskone = debug_bpl_mask_one;
+		pl->valid = true;
+		p2c_jobs[cnt++] = lineno;
+	}
+	if (cnt < P2C_MIN_LINES) {
+		p2c_decode (0, cnt);
+		return;
+	}
+	int band = cnt / (P2C_WORKERS + 1);
+	for (int i = 0; i < P2C_WORKERS; i++) {
+		struct p2c_worker *w = &p2c_workers[i];
+		w->first = i * band;
+		w->last = (i + 1) * band;
+		uae_sem_post (&w->start);
+	}
+	p2c_decode (P2C_WORKERS * band, cnt);
+	for (int i = 0; i < P2C_WORKERS; i++)
+		uae_sem_wait (&p2c_workers[i].done);
+}
+
+static void pfield_doline (int lineno)
+{
+	int wordcount = dp_for_drawing->plflinelen;
+	uae_u32 *data = pixdata.apixels_l + MAX_PIXELS_PER_LINE / 4;
+
+	if (lineno >= 0 && lineno < P2C_LINES) {
+		struct p2c_line *pl = &p2c_lines[lineno];
+		if (pl->valid && pl->planes == bplplanecnt && pl->wordcount == wordcount && pl->mask == debug_bpl_mask && pl->maskone == debug_bpl_mask_one) {
+			pl->valid = false;
+			memcpy (data, p2c_frame + lineno * MAX_PIXELS_PER_LINE, wordcount * 32);
+			return;
+		}
+		pl->valid = false;
+	}
+	pfield_doline_planes (data, lineno, bplplanecnt, wordcount);
 }
 
 void init_row_map (void)
@@ -3110,6 +3242,7 @@ static void draw_frame2 (struct vidbuffer *vbin, struct vidbuffer *vbout)
 #if LARGEST_LINE_DEBUG
 	int largest = 0;
 #endif
+	p2c_prepass (vbin);
 	for (i = 0; i < max_ypos_thisframe; i++) {
 		int i1 = i + min_ypos_for_screen;
 		int line = i + thisframe_y_adjust_real;
@@ -3591,6 +3724,9 @@ void reset_drawing (void)
 void drawing_init (void)
 {
 	gen_pfield_tables ();
+	pfield_doline_init ();
+	p2c_free ();
+	p2c_init ();
 
 	uae_sem_init (&gui_sem, 0, 1);
 #ifdef PICASSO96
@@ -3608,6 +3744,11 @@ void drawing_init (void)
 	reset_drawing ();
 }
 
+void drawing_free (void)
+{
+	p2c_free ();
+}
+
 int isvsync_chipset (void)
 {
 	if (picasso_on || !currprefs.gfx_apmode[0].gfx_vsync || (currprefs.gfx_apmode[0].gfx_vsync == 0 && !currprefs.gfx_apmode[0].gfx_fullscreen))
@@ -663,6 +663,7 @@ int enforcer_enable (int enfmode)
 		chipmem_bank.check = chipmem_check2;
 
 		enforcer_installed = 1;
+		chipmem_handlers_changed ();
 	}
 	return 1;
 }
@@ -689,6 +690,7 @@ int enforcer_disable (void)
 		chipmem_bank.check = saved_chipmem_check;
 
 		enforcer_installed = 0;
+		chipmem_handlers_changed ();
 	}
 	return 1;
 }
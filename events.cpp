@@ -125,53 +125,156 @@ void do_cycles_slow (unsigned long cycles_to_add)
 	currcycle += cycles_to_add;
 }
 
+/* Pending event2's ordered by evtime. Entries are not removed when a slot
+ * is cancelled or rescheduled (event2_remevent() and friends only clear
+ * the slot), they are dropped when they reach the top and no longer match
+ * their slot. */
+struct ev2_heapent
+{
+	evt evtime;
+	int no;
+};
+static struct ev2_heapent *ev2_heap;
+static int ev2_heap_cnt, ev2_heap_max;
+
+STATIC_INLINE bool ev2_heap_before (int a, int b)
+{
+	return (signed long)(ev2_heap[a].evtime - ev2_heap[b].evtime) < 0;
+}
+
+static void ev2_heap_swap (int a, int b)
+{
+	struct ev2_heapent t = ev2_heap[a];
+	ev2_heap[a] = ev2_heap[b];
+	ev2_heap[b] = t;
+}
+
+static void ev2_heap_up (int i)
+{
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!ev2_heap_before (i, parent))
+			break;
+		ev2_heap_swap (i, parent);
+		i = parent;
+	}
+}
+
+static void ev2_heap_down (int i)
+{
+	for (;;) {
+		int c = i * 2 + 1;
+		if (c >= ev2_heap_cnt)
+			break;
+		if (c + 1 < ev2_heap_cnt && ev2_heap_before (c + 1, c))
+			c++;
+		if (!ev2_heap_before (c, i))
+			break;
+		ev2_heap_swap (i, c);
+		i = c;
+	}
+}
+
+static void ev2_heap_pop (void)
+{
+	ev2_heap[0] = ev2_heap[--ev2_heap_cnt];
+	ev2_heap_down (0);
+}
+
+/* drop all stale entries, one entry per active slot */
+static void ev2_heap_rebuild (void)
+{
+	ev2_heap_cnt = 0;
+	for (int i = 0; i < ev2_max; i++) {
+		if (eventtab2[i].active) {
+			ev2_heap[ev2_heap_cnt].evtime = eventtab2[i].evtime;
+			ev2_heap[ev2_heap_cnt].no = i;
+			ev2_heap_cnt++;
+		}
+	}
+	for (int i = ev2_heap_cnt / 2 - 1; i >= 0; i--)
+		ev2_heap_down (i);
+}
+
+static void ev2_heap_push (int no)
+{
+	if (ev2_heap_cnt >= ev2_heap_max) {
+		if (ev2_heap_max < ev2_max * 4) {
+			struct ev2_heapent *h = xrealloc (struct ev2_heapent, ev2_heap, ev2_max * 4);
+			if (h) {
+				ev2_heap = h;
+				ev2_heap_max = ev2_max * 4;
+			}
+		}
+		if (ev2_heap_cnt >= ev2_heap_max) {
+			// slot no is already active, rebuild picks it up
+			if (ev2_heap_max >= ev2_max)
+				ev2_heap_rebuild ();
+			return;
+		}
+	}
+	ev2_heap[ev2_heap_cnt].evtime = eventtab2[no].evtime;
+	ev2_heap[ev2_heap_cnt].no = no;
+	ev2_heap_cnt++;
+	ev2_heap_up (ev2_heap_cnt - 1);
+}
+
+void event2_clear (void)
+{
+	for (int i = 0; i < ev2_max; i++)
+		eventtab2[i].active = 0;
+	ev2_heap_cnt = 0;
+}
+
 void MISC_handler (void)
 {
-	static bool dorecheck;
-	bool recheck;
-	int i;
-	evt mintime;
 	evt ct = get_cycles ();
 	static int recursive;
 
-	if (recursive) {
-		dorecheck = true;
+	if (recursive)
 		return;
-	}
 	recursive++;
 	eventtab[ev_misc].active = 0;
-	recheck = true;
-	while (recheck) {
-		recheck = false;
-		mintime = ~0L;
-		for (i = 0; i < ev2_max; i++) {
-			if (eventtab2[i].active) {
-				if (eventtab2[i].evtime == ct) {
-					eventtab2[i].active = false;
-					event2_count--;
-					eventtab2[i].handler (eventtab2[i].data);
-					if (dorecheck || eventtab2[i].active) {
-						recheck = true;
-						dorecheck = false;
-					}
-				} else {
-					evt eventtime = eventtab2[i].evtime - ct;
-					if (eventtime < mintime)
-						mintime = eventtime;
-				}
-			}
+	// events added by the handlers go into the heap and are picked up here too
+	while (ev2_heap_cnt > 0) {
+		int no = ev2_heap[0].no;
+		if (!eventtab2[no].active || eventtab2[no].evtime != ev2_heap[0].evtime) {
+			ev2_heap_pop ();
+			continue;
 		}
+		if ((signed long)(eventtab2[no].evtime - ct) > 0)
+			break;
+		ev2_heap_pop ();
+		eventtab2[no].active = false;
+		event2_count--;
+		eventtab2[no].handler (eventtab2[no].data);
 	}
-	if (mintime != ~0UL) {
+	if (ev2_heap_cnt > 0) {
 		eventtab[ev_misc].active = true;
 		eventtab[ev_misc].oldcycles = ct;
-		eventtab[ev_misc].evtime = ct + mintime;
+		eventtab[ev_misc].evtime = ev2_heap[0].evtime;
 		events_schedule ();
 	}
 	recursive--;
 }
 
 
+/* all slots in use: double the pool, static slots stay until first grow */
+static int event2_grow (void)
+{
+	int newmax = ev2_max * 2;
+	struct ev2 *e = xcalloc (struct ev2, newmax);
+
+	if (!e)
+		return -1;
+	memcpy (e, eventtab2, ev2_max * sizeof (struct ev2));
+	if (eventtab2 != eventtab2_static)
+		xfree (eventtab2);
+	eventtab2 = e;
+	ev2_max = newmax;
+	return ev2_max / 2;
+}
+
 void event2_newevent_xx (int no, evt t, uae_u32 data, evfunc2 func)
 {
 	evt et;
@@ -191,8 +294,13 @@ void event2_newevent_xx (int no, evt t, uae_u32 data, evfunc2 func)
 			if (no == ev2_max)
 				no = ev2_misc;
 			if (no == next) {
-				write_log (_T("out of event2's!\n"));
-				return;
+				no = event2_grow ();
+				if (no < 0) {
+					write_log (_T("out of event2's!\n"));
+					return;
+				}
+				event2_count++;
+				break;
 			}
 		}
 		next = no;
@@ -201,6 +309,7 @@ void event2_newevent_xx (int no, evt t, uae_u32 data, evfunc2 func)
 	eventtab2[no].evtime = et;
 	eventtab2[no].handler = func;
 	eventtab2[no].data = data;
+	ev2_heap_push (no);
 	MISC_handler ();
 }
 
@@ -1211,7 +1211,7 @@ typedef struct exallkey {
 
 #define EXKEYS 128
 #define EXALLKEYS 100
-#define MAX_AINO_HASH 128
+#define AINO_HASH_MIN 1024
 #define NOTIFY_HASH_SIZE 127
 
 /* handler state info */
@@ -1252,7 +1252,9 @@ typedef struct _unit {
 
 	a_inode rootnode;
 	unsigned long aino_cache_size;
-	a_inode *aino_hash[MAX_AINO_HASH];
+	a_inode **aino_hash[AINO_HASH_MAX];
+	unsigned int aino_hash_size;
+	unsigned long aino_hash_count;
 	unsigned long nr_cache_hits;
 	unsigned long nr_cache_lookups;
 
@@ -1270,6 +1272,11 @@ typedef struct _unit {
 	struct zvolume *zarchive;
 	void *cdfs_superblock;
 
+	/* ACTION_READ read-ahead helper */
+	struct fs_readahead *readahead;
+	/* ACTION_READ/ACTION_WRITE host I/O workers */
+	struct fs_iopool *iopool;
+
 	TCHAR *mount_volume;
 	TCHAR *mount_rootdir;
 	bool mount_readonly;
@@ -2126,11 +2133,114 @@ static void de_recycle_aino (Unit *unit, a_inode *aino)
 	unit->aino_cache_size--;
 }
 
+enum { AINO_HASH_UNIQ, AINO_HASH_ANAME, AINO_HASH_NNAME };
+
+/* Hash of the last path component. Amiga names are looked up with
+* same_aname(), which also matches different case, compatibility
+* characters and composed/decomposed forms, so they are hashed by
+* aname_hash() from the same collation. Native names compare exactly.  */
+static uae_u32 aino_name_hash (uae_u32 parent, const TCHAR *name, int idx)
+{
+	const TCHAR *p = _tcsrchr (name, idx == AINO_HASH_ANAME ? '/' : FSDB_DIR_SEPARATOR);
+	uae_u32 h = 2166136261u ^ parent;
+
+	if (p)
+		name = p + 1;
+	if (idx == AINO_HASH_ANAME)
+		return aname_hash (h, name);
+	for (; *name; name++)
+		h = (h ^ *name) * 16777619;
+	return h;
+}
+
+static void aino_hash_link (Unit *unit, a_inode *aino)
+{
+	for (int i = 0; i < AINO_HASH_MAX; i++) {
+		a_inode **ap = &unit->aino_hash[i][aino->hashval[i] & (unit->aino_hash_size - 1)];
+		aino->hashnext[i] = *ap;
+		*ap = aino;
+	}
+}
+
+static void aino_hash_resize (Unit *unit)
+{
+	unsigned int oldsize = unit->aino_hash_size;
+	unsigned int newsize = oldsize ? oldsize * 2 : AINO_HASH_MIN;
+	a_inode **old[AINO_HASH_MAX];
+	int i;
+
+	for (i = 0; i < AINO_HASH_MAX; i++) {
+		old[i] = unit->aino_hash[i];
+		unit->aino_hash[i] = xcalloc (a_inode*, newsize);
+		if (!unit->aino_hash[i]) {
+			while (i >= 0) {
+				xfree (unit->aino_hash[i]);
+				unit->aino_hash[i] = old[i];
+				i--;
+			}
+			return;
+		}
+	}
+	unit->aino_hash_size = newsize;
+	/* uniq chains reach every indexed aino exactly once */
+	for (unsigned int b = 0; b < oldsize; b++) {
+		a_inode *a = old[AINO_HASH_UNIQ][b];
+		while (a) {
+			a_inode *next = a->hashnext[AINO_HASH_UNIQ];
+			aino_hash_link (unit, a);
+			a = next;
+		}
+	}
+	for (i = 0; i < AINO_HASH_MAX; i++)
+		xfree (old[i]);
+}
+
+static void aino_hash_add (Unit *unit, a_inode *aino)
+{
+	if (unit->aino_hash_count >= unit->aino_hash_size)
+		aino_hash_resize (unit);
+	if (!unit->aino_hash_size)
+		return;
+	aino->hashval[AINO_HASH_UNIQ] = aino->uniq;
+	aino->hashval[AINO_HASH_ANAME] = aino_name_hash (aino->parent->uniq, aino->aname, AINO_HASH_ANAME);
+	aino->hashval[AINO_HASH_NNAME] = aino_name_hash (aino->parent->uniq, aino->nname, AINO_HASH_NNAME);
+	aino_hash_link (unit, aino);
+	unit->aino_hash_count++;
+}
+
+static void aino_hash_remove (Unit *unit, a_inode *aino)
+{
+	bool found = false;
+
+	if (!unit->aino_hash_size)
+		return;
+	for (int i = 0; i < AINO_HASH_MAX; i++) {
+		a_inode **ap = &unit->aino_hash[i][aino->hashval[i] & (unit->aino_hash_size - 1)];
+		while (*ap && *ap != aino)
+			ap = &(*ap)->hashnext[i];
+		if (*ap) {
+			*ap = aino->hashnext[i];
+			found = true;
+		}
+		aino->hashnext[i] = 0;
+	}
+	if (found)
+		unit->aino_hash_count--;
+}
+
+static void aino_hash_free (Unit *unit)
+{
+	for (int i = 0; i < AINO_HASH_MAX; i++) {
+		xfree (unit->aino_hash[i]);
+		unit->aino_hash[i] = 0;
+	}
+	unit->aino_hash_size = 0;
+	unit->aino_hash_count = 0;
+}
+
 static void dispose_aino (Unit *unit, a_inode **aip, a_inode *aino)
 {
-	int hash = aino->uniq % MAX_AINO_HASH;
-	if (unit->aino_hash[hash] == aino)
-		unit->aino_hash[hash] = 0;
+	aino_hash_remove (unit, aino);
 
 	if (aino->dirty && aino->parent)
 		fsdb_dir_writeback (aino->parent);
@@ -2287,7 +2397,11 @@ static void move_aino_children (Unit *unit, a_inode *from, a_inode *to)
 	aino_test (to);
 	to->child = from->child;
 	from->child = 0;
+	for (a_inode *a = to->child; a; a = a->sibling)
+		aino_hash_remove (unit, a);
 	update_child_names (unit, to->child, to);
+	for (a_inode *a = to->child; a; a = a->sibling)
+		aino_hash_add (unit, a);
 }
 
 static void delete_aino (Unit *unit, a_inode *aino)
@@ -2366,17 +2480,19 @@ static a_inode *lookup_sub (a_inode *dir, uae_u32 uniq)
 static a_inode *lookup_aino (Unit *unit, uae_u32 uniq)
 {
 	a_inode *a;
-	int hash = uniq % MAX_AINO_HASH;
 
 	if (uniq == 0)
 		return &unit->rootnode;
-	a = unit->aino_hash[hash];
-	if (a == 0 || a->uniq != uniq)
-		a = lookup_sub (&unit->rootnode, uniq);
-	else
-		unit->nr_cache_hits++;
 	unit->nr_cache_lookups++;
-	unit->aino_hash[hash] = a;
+	if (unit->aino_hash_size) {
+		a = unit->aino_hash[AINO_HASH_UNIQ][uniq & (unit->aino_hash_size - 1)];
+		while (a && a->uniq != uniq)
+			a = a->hashnext[AINO_HASH_UNIQ];
+		if (a)
+			unit->nr_cache_hits++;
+	} else {
+		a = lookup_sub (&unit->rootnode, uniq);
+	}
 	aino_test (a);
 	return a;
 }
@@ -2552,6 +2668,7 @@ static void init_child_aino_tree (Unit *unit, a_inode *base, a_inode *aino)
 	base->child = aino;
 	aino->next = aino->prev = 0;
 	aino->volflags = unit->volflags;
+	aino_hash_add (unit, aino);
 }
 
 static void init_child_aino (Unit *unit, a_inode *base, a_inode *aino)
@@ -2648,26 +2765,57 @@ static a_inode *create_child_aino (Unit *unit, a_inode *base, TCHAR *rel, int is
 	return aino;
 }
 
-static a_inode *lookup_child_aino (Unit *unit, a_inode *base, TCHAR *rel, int *err)
+static bool match_child_aname (Unit *unit, a_inode *c, const TCHAR *rel, int l0)
+{
+	int l1 = _tcslen (c->aname);
+	return l0 <= l1 && same_aname (rel, c->aname + l1 - l0)
+		&& (l0 == l1 || c->aname[l1-l0-1] == '/') && c->mountcount == unit->mountcount;
+}
+
+static bool match_child_nname (Unit *unit, a_inode *c, const TCHAR *rel, int l0)
+{
+	int l1 = _tcslen (c->nname);
+	/* Note: using _tcscmp here.  */
+	return l0 <= l1 && _tcscmp (rel, c->nname + l1 - l0) == 0
+		&& (l0 == l1 || c->nname[l1-l0-1] == FSDB_DIR_SEPARATOR) && c->mountcount == unit->mountcount;
+}
+
+/* Find an already known child of BASE through the name index.  */
+static a_inode *find_child_aino (Unit *unit, a_inode *base, const TCHAR *rel, int idx)
 {
-	a_inode *c = base->child;
 	int l0 = _tcslen (rel);
+	a_inode *c;
+
+	if (!unit->aino_hash_size) {
+		for (c = base->child; c; c = c->sibling) {
+			if (idx == AINO_HASH_ANAME ? match_child_aname (unit, c, rel, l0) : match_child_nname (unit, c, rel, l0))
+				break;
+		}
+		return c;
+	}
+	uae_u32 h = aino_name_hash (base->uniq, rel, idx);
+	for (c = unit->aino_hash[idx][h & (unit->aino_hash_size - 1)]; c; c = c->hashnext[idx]) {
+		if (c->hashval[idx] != h || c->parent != base)
+			continue;
+		if (idx == AINO_HASH_ANAME ? match_child_aname (unit, c, rel, l0) : match_child_nname (unit, c, rel, l0))
+			break;
+	}
+	return c;
+}
+
+static a_inode *lookup_child_aino (Unit *unit, a_inode *base, TCHAR *rel, int *err)
+{
+	a_inode *c;
 
 	aino_test (base);
-	aino_test (c);
 
 	if (base->dir == 0) {
 		*err = ERROR_OBJECT_WRONG_TYPE;
 		return 0;
 	}
 
-	while (c != 0) {
-		int l1 = _tcslen (c->aname);
-		if (l0 <= l1 && same_aname (rel, c->aname + l1 - l0)
-			&& (l0 == l1 || c->aname[l1-l0-1] == '/') && c->mountcount == unit->mountcount)
-			break;
-		c = c->sibling;
-	}
+	c = find_child_aino (unit, base, rel, AINO_HASH_ANAME);
+	aino_test (c);
 	if (c != 0)
 		return c;
 	c = new_child_aino (unit, base, rel);
@@ -2679,22 +2827,14 @@ static a_inode *lookup_child_aino (Unit *unit, a_inode *base, TCHAR *rel, int *e
 /* Different version because for this one, REL is an nname.  */
 static a_inode *lookup_child_aino_for_exnext (Unit *unit, a_inode *base, TCHAR *rel, uae_u32 *err, uae_u64 uniq_external, struct virtualfilesysobject *vfso)
 {
-	a_inode *c = base->child;
-	int l0 = _tcslen (rel);
+	a_inode *c;
 	int isvirtual = unit->volflags & (MYVOLUMEINFO_ARCHIVE | MYVOLUMEINFO_CDFS);
 
 	aino_test (base);
-	aino_test (c);
 
 	*err = 0;
-	while (c != 0) {
-		int l1 = _tcslen (c->nname);
-		/* Note: using _tcscmp here.  */
-		if (l0 <= l1 && _tcscmp (rel, c->nname + l1 - l0) == 0
-			&& (l0 == l1 || c->nname[l1-l0-1] == FSDB_DIR_SEPARATOR) && c->mountcount == unit->mountcount)
-			break;
-		c = c->sibling;
-	}
+	c = find_child_aino (unit, base, rel, AINO_HASH_NNAME);
+	aino_test (c);
 	if (c != 0)
 		return c;
 	if (!isvirtual && !vfso)
@@ -2905,8 +3045,7 @@ static Unit *startup_create_unit (UnitInfo *uinfo, int num)
 	unit->rootnode.volflags = uinfo->volflags;
 	aino_test_init (&unit->rootnode);
 	unit->aino_cache_size = 0;
-	for (i = 0; i < MAX_AINO_HASH; i++)
-		unit->aino_hash[i] = 0;
+	aino_hash_free (unit);
 	return unit;
 }
 
@@ -3193,10 +3332,192 @@ static void
 	do_info (unit, packet, GET_PCK_ARG2 (packet) << 2, false);
 }
 
+#ifdef UAE_FILESYS_THREADS
+
+/* Sequential ACTION_READ read-ahead: after a large read the next chunk
+* of the same file is fetched on a helper thread while the Amiga side
+* is still busy with the previous one. The packet loop waits for it
+* before touching any key, so the helper never races the handle, and
+* the helper puts the handle position back where it found it.  */
+
+#define FS_READAHEAD_MIN 8192
+#define FS_READAHEAD_MAX (1024 * 1024)
+
+struct fs_readahead
+{
+	uae_sem_t start, done;
+	bool busy, quit;
+	Key *k;
+	uae_u32 uniq;
+	uae_u64 pos;
+	uae_u32 size;
+	int actual;
+	uae_u8 *buf;
+	unsigned long hits, misses;
+};
+
+static void *readahead_thread (void *v)
+{
+	struct fs_readahead *ra = (struct fs_readahead*)v;
+
+	for (;;) {
+		uae_s64 old;
+		uae_sem_wait (&ra->start);
+		if (ra->quit)
+			break;
+		old = fs_lseek64 (ra->k->fd, 0, SEEK_CUR);
+		if (old < 0 || fs_lseek64 (ra->k->fd, ra->pos, SEEK_SET) < 0) {
+			ra->actual = -1;
+		} else {
+			ra->actual = (int)fs_read (ra->k->fd, ra->buf, ra->size);
+			fs_lseek64 (ra->k->fd, old, SEEK_SET);
+		}
+		uae_sem_post (&ra->done);
+	}
+	uae_sem_post (&ra->done);
+	return 0;
+}
+
+static void readahead_sync (Unit *unit)
+{
+	struct fs_readahead *ra = unit->readahead;
+	if (ra && ra->busy) {
+		uae_sem_wait (&ra->done);
+		ra->busy = false;
+	}
+}
+
+/* Called for every packet before it is handled. Anything that may
+* modify or close a file drops the buffered data.  */
+static void readahead_packet (Unit *unit, uae_s32 type)
+{
+	struct fs_readahead *ra = unit->readahead;
+
+	if (!ra)
+		return;
+	readahead_sync (unit);
+	switch (type)
+	{
+	case ACTION_READ:
+	case ACTION_LOCATE_OBJECT:
+	case ACTION_FREE_LOCK:
+	case ACTION_COPY_DIR:
+	case ACTION_SAME_LOCK:
+	case ACTION_PARENT:
+	case ACTION_INFO:
+	case ACTION_DISK_INFO:
+	case ACTION_IS_FILESYSTEM:
+	case ACTION_CURRENT_VOLUME:
+	case ACTION_EXAMINE_OBJECT:
+	case ACTION_EXAMINE_NEXT:
+	case ACTION_EXAMINE_ALL:
+	case ACTION_EXAMINE_ALL_END:
+	case ACTION_EXAMINE_OBJECT64:
+	case ACTION_EXAMINE_NEXT64:
+	case ACTION_READ_LINK:
+		break;
+	default:
+		ra->k = NULL;
+		break;
+	}
+}
+
+static void readahead_forget (Unit *unit, Key *k)
+{
+	struct fs_readahead *ra = unit->readahead;
+	if (ra && ra->k == k) {
+		readahead_sync (unit);
+		ra->k = NULL;
+	}
+}
+
+static bool readahead_read (Unit *unit, Key *k, uae_u8 *dst, uae_u32 size, uae_u32 *actual)
+{
+	struct fs_readahead *ra = unit->readahead;
+
+	if (!ra || !ra->k)
+		return false;
+	if (size > FS_READAHEAD_MAX) {
+		// could never be satisfied from the buffer
+		readahead_forget (unit, k);
+		return false;
+	}
+	readahead_sync (unit);
+	if (ra->k != k || ra->uniq != k->uniq || ra->pos != k->file_pos || ra->actual < 0
+		|| (size > ra->size && (uae_u32)ra->actual == ra->size)) {
+		ra->misses++;
+		ra->k = NULL;
+		return false;
+	}
+	*actual = size < (uae_u32)ra->actual ? size : ra->actual;
+	memcpy (dst, ra->buf, *actual);
+	ra->hits++;
+	ra->k = NULL;
+	return true;
+}
+
+static void readahead_next (Unit *unit, Key *k, uae_u32 size)
+{
+	struct fs_readahead *ra = unit->readahead;
+
+	if (size < FS_READAHEAD_MIN || size > FS_READAHEAD_MAX || !k->fd || k->fd->fstype != FS_DIRECTORY)
+		return;
+	if (!ra) {
+		ra = xcalloc (struct fs_readahead, 1);
+		ra->buf = xmalloc (uae_u8, FS_READAHEAD_MAX);
+		if (!ra->buf) {
+			xfree (ra);
+			return;
+		}
+		uae_sem_init (&ra->start, 0, 0);
+		uae_sem_init (&ra->done, 0, 0);
+		uae_start_thread (_T("filesys_ra"), readahead_thread, ra, NULL);
+		unit->readahead = ra;
+	}
+	readahead_sync (unit);
+	ra->k = k;
+	ra->uniq = k->uniq;
+	ra->pos = k->file_pos;
+	ra->size = size;
+	ra->busy = true;
+	uae_sem_post (&ra->start);
+}
+
+static void readahead_free (Unit *unit)
+{
+	struct fs_readahead *ra = unit->readahead;
+
+	if (!ra)
+		return;
+	readahead_sync (unit);
+	if (ra->hits || ra->misses)
+		write_log (_T("FS: unit %d: read-ahead %lu hits, %lu misses\n"), unit->unit, ra->hits, ra->misses);
+	ra->quit = true;
+	uae_sem_post (&ra->start);
+	uae_sem_wait (&ra->done);
+	uae_sem_destroy (&ra->start);
+	uae_sem_destroy (&ra->done);
+	xfree (ra->buf);
+	xfree (ra);
+	unit->readahead = NULL;
+}
+
+#else
+
+static void readahead_packet (Unit *unit, uae_s32 type) { }
+static bool readahead_read (Unit *unit, Key *k, uae_u8 *dst, uae_u32 size, uae_u32 *actual) { return false; }
+static void readahead_next (Unit *unit, Key *k, uae_u32 size) { }
+static void readahead_forget (Unit *unit, Key *k) { }
+static void readahead_free (Unit *unit) { }
+
+#endif
+
 static void free_key (Unit *unit, Key *k)
 {
 	Key *k1;
 	Key *prev = 0;
+
+	readahead_forget (unit, k);
 	for (k1 = unit->keys; k1; k1 = k1->next) {
 		if (k == k1) {
 			if (prev)
@@ -4986,6 +5307,266 @@ static void
 	PUT_PCK_RES2 (packet, 0);
 }
 
+#ifdef UAE_FILESYS_THREADS
+
+/* Host I/O worker pool: when more than one packet is in flight, ACTION_READ
+* and ACTION_WRITE on plain host files are handed to worker threads so that
+* independent keys are read and written concurrently. Each key has at most
+* one job queued, packets are still replied in the order they arrived and
+* every other packet waits until the pool is empty.  */
+
+#define FS_IOPOOL_THREADS 4
+#define FS_IOPOOL_JOBS 8
+
+struct fs_iojob
+{
+	Unit *unit;
+	Key *k;
+	dpacket packet;
+	uaecptr msg;
+	uaecptr addr;
+	uae_u8 *realpt;
+	uae_u64 pos;
+	uae_u32 size;
+	bool write;
+	bool done;
+	int actual;
+	int err;
+};
+
+struct fs_iopool
+{
+	uae_sem_t lock, start, drained;
+	bool quit, draining;
+	int head, next, count;
+	struct fs_iojob jobs[FS_IOPOOL_JOBS];
+	uae_thread_id tid[FS_IOPOOL_THREADS];
+	unsigned long queued;
+};
+
+/* Called with the pool lock held. Replies every finished job at the head
+* of the queue, a finished job behind a running one has to wait.  */
+static void iopool_retire (struct fs_iopool *p)
+{
+	while (p->count > 0 && p->jobs[p->head].done) {
+		struct fs_iojob *j = &p->jobs[p->head];
+		dpacket packet = j->packet;
+
+		if (j->write) {
+			PUT_PCK_RES1 (packet, j->actual);
+			if ((uae_u32)j->actual != j->size)
+				PUT_PCK_RES2 (packet, j->err);
+			if (j->actual != -1)
+				j->k->file_pos += j->actual;
+		} else {
+			if (j->actual == 0) {
+				PUT_PCK_RES1 (packet, 0);
+				PUT_PCK_RES2 (packet, 0);
+			} else if (j->actual < 0) {
+				PUT_PCK_RES1 (packet, 0);
+				PUT_PCK_RES2 (packet, j->err);
+			} else {
+				PUT_PCK_RES1 (packet, j->actual);
+				j->k->file_pos += j->actual;
+			}
+			flush_dcache (j->addr, j->size);
+		}
+		TRACE((_T("=%d (pool)\n"), j->actual));
+		/* Same as filesys_iteration() does for the packets it handles itself. */
+		put_long (j->msg + 4, 0xffffffff);
+		j->unit->cmds_sent++;
+		do_uae_int_requested ();
+		j->k = NULL;
+		p->head = (p->head + 1) % FS_IOPOOL_JOBS;
+		p->count--;
+	}
+	if (p->count == 0 && p->draining) {
+		p->draining = false;
+		uae_sem_post (&p->drained);
+	}
+}
+
+static void *iopool_thread (void *v)
+{
+	struct fs_iopool *p = (struct fs_iopool*)v;
+
+	for (;;) {
+		struct fs_iojob *j;
+		uae_sem_wait (&p->start);
+		uae_sem_wait (&p->lock);
+		if (p->quit) {
+			uae_sem_post (&p->lock);
+			break;
+		}
+		j = &p->jobs[p->next];
+		p->next = (p->next + 1) % FS_IOPOOL_JOBS;
+		uae_sem_post (&p->lock);
+
+		/* The key belongs to this job until it is retired. */
+		j->err = 0;
+		if (fs_lseek64 (j->k->fd, j->pos, SEEK_SET) < 0)
+			j->actual = -1;
+		else if (j->write)
+			j->actual = (int)fs_write (j->k->fd, j->realpt, j->size);
+		else
+			j->actual = (int)fs_read (j->k->fd, j->realpt, j->size);
+		if (j->actual < 0 || (j->write && (uae_u32)j->actual != j->size))
+			j->err = dos_errno ();
+
+		uae_sem_wait (&p->lock);
+		j->done = true;
+		iopool_retire (p);
+		uae_sem_post (&p->lock);
+	}
+	return 0;
+}
+
+/* Workers reply packets too, keep the counter update atomic. */
+static void iopool_cmd_sent (Unit *unit)
+{
+	struct fs_iopool *p = unit->iopool;
+
+	if (!p) {
+		unit->cmds_sent++;
+		return;
+	}
+	uae_sem_wait (&p->lock);
+	unit->cmds_sent++;
+	uae_sem_post (&p->lock);
+}
+
+static void iopool_drain (Unit *unit)
+{
+	struct fs_iopool *p = unit->iopool;
+
+	if (!p)
+		return;
+	uae_sem_wait (&p->lock);
+	while (p->count > 0) {
+		p->draining = true;
+		uae_sem_post (&p->lock);
+		uae_sem_wait (&p->drained);
+		uae_sem_wait (&p->lock);
+	}
+	uae_sem_post (&p->lock);
+}
+
+static bool iopool_busy (struct fs_iopool *p, Key *k)
+{
+	bool busy = false;
+
+	uae_sem_wait (&p->lock);
+	for (int i = 0; i < p->count; i++) {
+		if (p->jobs[(p->head + i) % FS_IOPOOL_JOBS].k == k)
+			busy = true;
+	}
+	uae_sem_post (&p->lock);
+	return busy;
+}
+
+static struct fs_iopool *iopool_alloc (Unit *unit)
+{
+	struct fs_iopool *p = xcalloc (struct fs_iopool, 1);
+
+	uae_sem_init (&p->lock, 0, 1);
+	uae_sem_init (&p->start, 0, 0);
+	uae_sem_init (&p->drained, 0, 0);
+	for (int i = 0; i < FS_IOPOOL_THREADS; i++)
+		uae_start_thread (_T("filesys_io"), iopool_thread, p, &p->tid[i]);
+	unit->iopool = p;
+	return p;
+}
+
+/* Called for every packet before it is handled. Returns true if the packet
+* was queued to the pool and will be replied later, otherwise the pool has
+* been emptied and the packet is handled the normal way.  */
+static bool iopool_packet (Unit *unit, dpacket packet, uae_u32 msg, uae_s32 type)
+{
+	struct fs_iopool *p = unit->iopool;
+	struct fs_iojob *j;
+	Key *k;
+	uaecptr addr;
+	uae_u32 size;
+	bool write = type == ACTION_WRITE;
+
+	if ((type != ACTION_READ && type != ACTION_WRITE) || !msg)
+		goto sync;
+	if (unit->inhibited || !filesys_isvolume (unit))
+		goto sync;
+	/* nothing else outstanding, plain synchronous I/O (and read-ahead) is faster */
+	if ((!p || !p->count) && !comm_pipe_has_data (unit->ui.unit_pipe))
+		goto sync;
+	k = lookup_key (unit, GET_PCK_ARG1 (packet));
+	addr = GET_PCK_ARG2 (packet);
+	size = GET_PCK_ARG3 (packet);
+	if (!k || !k->fd || k->fd->fstype != FS_DIRECTORY || k->aino->vfso || !size || !valid_address (addr, size))
+		goto sync;
+	if (write && (unit->ui.readonly || unit->ui.locked))
+		goto sync;
+	if (!p)
+		p = iopool_alloc (unit);
+	if (p->count == FS_IOPOOL_JOBS || iopool_busy (p, k))
+		iopool_drain (unit);
+
+	TRACE((_T("%s(%s,0x%lx,%ld) (pool)\n"), write ? _T("ACTION_WRITE") : _T("ACTION_READ"), k->aino->nname, addr, size));
+	gui_flicker_led (UNIT_LED(unit), unit->unit, write ? 2 : 1);
+	readahead_forget (unit, k);
+	if (write)
+		k->notifyactive = 1;
+
+	uae_sem_wait (&p->lock);
+	j = &p->jobs[(p->head + p->count) % FS_IOPOOL_JOBS];
+	j->unit = unit;
+	j->k = k;
+	j->packet = packet;
+	j->msg = msg;
+	j->addr = addr;
+	j->realpt = get_real_address (addr);
+	j->pos = k->file_pos;
+	j->size = size;
+	j->write = write;
+	j->done = false;
+	p->count++;
+	p->queued++;
+	uae_sem_post (&p->lock);
+	uae_sem_post (&p->start);
+	return true;
+sync:
+	iopool_drain (unit);
+	return false;
+}
+
+static void iopool_free (Unit *unit)
+{
+	struct fs_iopool *p = unit->iopool;
+
+	if (!p)
+		return;
+	iopool_drain (unit);
+	if (p->queued)
+		write_log (_T("FS: unit %d: %lu packets handled by the I/O pool\n"), unit->unit, p->queued);
+	uae_sem_wait (&p->lock);
+	p->quit = true;
+	uae_sem_post (&p->lock);
+	for (int i = 0; i < FS_IOPOOL_THREADS; i++)
+		uae_sem_post (&p->start);
+	for (int i = 0; i < FS_IOPOOL_THREADS; i++)
+		uae_wait_thread (p->tid[i]);
+	uae_sem_destroy (&p->lock);
+	uae_sem_destroy (&p->start);
+	uae_sem_destroy (&p->drained);
+	xfree (p);
+	unit->iopool = NULL;
+}
+
+#else
+
+static bool iopool_packet (Unit *unit, dpacket packet, uae_u32 msg, uae_s32 type) { return false; }
+static void iopool_drain (Unit *unit) { }
+static void iopool_free (Unit *unit) { }
+
+#endif
+
 static void
 	action_read (Unit *unit, dpacket packet)
 {
@@ -5067,13 +5648,15 @@ static void
 		/* normal fast read */
 		uae_u8 *realpt = get_real_address (addr);
 
-		if (key_seek(k, k->file_pos, SEEK_SET) < 0) {
-			PUT_PCK_RES1 (packet, 0);
-			PUT_PCK_RES2 (packet, dos_errno ());
-			return;
-		}
+		if (!readahead_read (unit, k, realpt, size, &actual)) {
+			if (key_seek(k, k->file_pos, SEEK_SET) < 0) {
+				PUT_PCK_RES1 (packet, 0);
+				PUT_PCK_RES2 (packet, dos_errno ());
+				return;
+			}
 
-		actual = fs_read (k->fd, realpt, size);
+			actual = fs_read (k->fd, realpt, size);
+		}
 
 		if (actual == 0) {
 			PUT_PCK_RES1 (packet, 0);
@@ -5084,6 +5667,8 @@ static void
 		} else {
 			PUT_PCK_RES1 (packet, actual);
 			k->file_pos += actual;
+			if (actual == size)
+				readahead_next (unit, k, size);
 		}
 		flush_dcache (addr, size);
 	}
@@ -5203,14 +5788,15 @@ static void
 		return;
 	}
 
-	res = key_seek(k, pos, whence);
+	/* file_pos is the real position, the handle may have been moved by someone else */
+	res = key_seek(k, temppos, SEEK_SET);
 	if (-1 == res || cur > MAXFILESIZE32) {
 		PUT_PCK_RES1 (packet, -1);
 		PUT_PCK_RES2 (packet, ERROR_SEEK_ERROR);
 		key_seek(k, cur, SEEK_SET);
 	} else {
 		PUT_PCK_RES1 (packet, cur);
-		k->file_pos = key_seek(k, 0, SEEK_CUR);
+		k->file_pos = temppos;
 	}
 }
 
@@ -5557,6 +6143,12 @@ static void
 		return;
 	}
 
+	/* Resolve the size against file_pos, the handle position can't be trusted.  */
+	if (whence == SEEK_CUR)
+		offset += k->file_pos;
+	else if (whence == SEEK_END)
+		offset += key_filesize(k);
+
 	gui_flicker_led (UNIT_LED(unit), unit->unit, 1);
 	k->notifyactive = 1;
 	/* If any open files have file pointers beyond this size, truncate only
@@ -5569,8 +6161,7 @@ static void
 	}
 
 	/* Write one then truncate: that should give the right size in all cases.  */
-	fs_lseek (k->fd, offset, whence);
-	offset = fs_lseek (k->fd, 0, SEEK_CUR);
+	fs_lseek (k->fd, offset, SEEK_SET);
 	fs_write (k->fd, /* whatever */(uae_u8*)&k1, 1);
 	if (k->file_pos > offset)
 		k->file_pos = offset;
@@ -5833,7 +6424,9 @@ static void
 	a2->comment = a1->comment;
 	a1->comment = 0;
 	a2->amigaos_mode = a1->amigaos_mode;
+	aino_hash_remove (unit, a2);
 	a2->uniq = a1->uniq;
+	aino_hash_add (unit, a2);
 	a2->elock = a1->elock;
 	a2->shlock = a1->shlock;
 	a2->has_dbentry = a1->has_dbentry;
@@ -5947,7 +6540,7 @@ static void action_change_file_position64 (Unit *unit, dpacket packet)
 	uae_s64 pos = GET_PCK64_ARG2 (packet);
 	long mode = GET_PCK64_ARG3 (packet);
 	long whence = SEEK_CUR;
-	uae_s64 res, cur;
+	uae_s64 res, cur, temppos;
 
 	PUT_PCK64_RES0 (packet, DP64_INIT);
 
@@ -5967,7 +6560,6 @@ static void action_change_file_position64 (Unit *unit, dpacket packet)
 
 	cur = k->file_pos;
 	{
-		uae_s64 temppos;
 		uae_s64 filesize = key_filesize(k);
 
 		if (whence == SEEK_CUR)
@@ -5983,7 +6575,7 @@ static void action_change_file_position64 (Unit *unit, dpacket packet)
 			return;
 		}
 	}
-	res = key_seek(k, pos, whence);
+	res = key_seek(k, temppos, SEEK_SET);
 
 	if (-1 == res) {
 		PUT_PCK64_RES1 (packet, DOS_FALSE);
@@ -5991,7 +6583,7 @@ static void action_change_file_position64 (Unit *unit, dpacket packet)
 	} else {
 		PUT_PCK64_RES1 (packet, TRUE);
 		PUT_PCK64_RES2 (packet, 0);
-		k->file_pos = key_seek(k, 0, SEEK_CUR);
+		k->file_pos = temppos;
 	}
 	TRACE((_T("= oldpos %lld newpos %lld\n"), cur, k->file_pos));
 }
@@ -6035,6 +6627,12 @@ static void action_change_file_size64 (Unit *unit, dpacket packet)
 		return;
 	}
 
+	/* Resolve the size against file_pos, the handle position can't be trusted.  */
+	if (whence == SEEK_CUR)
+		offset += k->file_pos;
+	else if (whence == SEEK_END)
+		offset += key_filesize(k);
+
 	gui_flicker_led (UNIT_LED(unit), unit->unit, 1);
 	k->notifyactive = 1;
 	/* If any open files have file pointers beyond this size, truncate only
@@ -6047,8 +6645,7 @@ static void action_change_file_size64 (Unit *unit, dpacket packet)
 	}
 
 	/* Write one then truncate: that should give the right size in all cases.  */
-	fs_lseek (k->fd, offset, whence);
-	offset = key_seek(k, offset, whence);
+	key_seek(k, offset, SEEK_SET);
 	fs_write (k->fd, /* whatever */(uae_u8*)&k1, 1);
 	if (k->file_pos > offset)
 		k->file_pos = offset;
@@ -6127,6 +6724,12 @@ static void action_set_file_size64(Unit *unit, dpacket packet)
 		return;
 	}
 
+	/* Resolve the size against file_pos, the handle position can't be trusted.  */
+	if (whence == SEEK_CUR)
+		offset += k->file_pos;
+	else if (whence == SEEK_END)
+		offset += key_filesize(k);
+
 	gui_flicker_led (UNIT_LED(unit), unit->unit, 1);
 	k->notifyactive = 1;
 	/* If any open files have file pointers beyond this size, truncate only
@@ -6139,8 +6742,7 @@ static void action_set_file_size64(Unit *unit, dpacket packet)
 	}
 
 	/* Write one then truncate: that should give the right size in all cases.  */
-	fs_lseek (k->fd, offset, whence);
-	offset = key_seek(k, offset, whence);
+	key_seek(k, offset, SEEK_SET);
 	fs_write (k->fd, /* whatever */(uae_u8*)&k1, 1);
 	if (k->file_pos > offset)
 		k->file_pos = offset;
@@ -6162,7 +6764,7 @@ static void action_seek64(Unit *unit, dpacket packet)
 	uae_s64 pos = get_quadp(GET_PCK64_ARG2(packet));
 	long mode = GET_PCK_ARG3(packet);
 	long whence = SEEK_CUR;
-	uae_s64 res, cur;
+	uae_s64 res, cur, temppos;
 
 	if (k == 0) {
 		PUT_PCK_RES1 (packet, DOS_FALSE);
@@ -6180,7 +6782,6 @@ static void action_seek64(Unit *unit, dpacket packet)
 
 	cur = k->file_pos;
 	{
-		uae_s64 temppos;
 		uae_s64 filesize = key_filesize(k);
 
 		if (whence == SEEK_CUR)
@@ -6196,7 +6797,7 @@ static void action_seek64(Unit *unit, dpacket packet)
 			return;
 		}
 	}
-	res = key_seek(k, pos, whence);
+	res = key_seek(k, temppos, SEEK_SET);
 
 	if (-1 == res) {
 		PUT_PCK_RES1 (packet, DOS_FALSE);
@@ -6204,7 +6805,7 @@ static void action_seek64(Unit *unit, dpacket packet)
 	} else {
 		PUT_PCK_RES1 (packet, TRUE);
 		set_quadp(GET_PCK_ARG3(packet), cur);
-		k->file_pos = key_seek(k, 0, SEEK_CUR);
+		k->file_pos = temppos;
 	}
 	TRACE((_T("= oldpos %lld newpos %lld\n"), cur, k->file_pos));
 }
@@ -6446,6 +7047,9 @@ static int handle_packet (Unit *unit, dpacket pck, uae_u32 msg)
 	PUT_PCK_RES2 (pck, 0);
 
 	TRACE((_T("unit=%x packet=%d\n"), unit, type));
+	readahead_packet (unit, type);
+	if (iopool_packet (unit, pck, msg, type))
+		return -1;
 	if (unit->inhibited && filesys_isvolume (unit)
 		&& type != ACTION_INHIBIT && type != ACTION_MORE_CACHE
 		&& type != ACTION_DISK_INFO) {
@@ -6551,6 +7155,8 @@ static int filesys_iteration(UnitInfo *ui)
 		if (pck != 0)
 		   return 1;
 		/* Death message received. */
+		if (ui->self)
+			iopool_drain (ui->self);
 		uae_sem_post (&ui->reset_sync_sem);
 		/* Die.  */
 		return 0;
@@ -6568,7 +7174,7 @@ static int filesys_iteration(UnitInfo *ui)
 		put_long (msg + 4, 0xffffffff);
 	}
 	/* Acquire the message lock, so that we know we can safely send the message. */
-	ui->self->cmds_sent++;
+	iopool_cmd_sent (ui->self);
 	/* The message is sent by our interrupt handler, so make sure an interrupt happens. */
 	do_uae_int_requested ();
 	/* Send back the locks. */
@@ -6676,6 +7282,8 @@ void filesys_free_handles (void)
 	for (u = units; u; u = u1) {
 		Key *k1, *knext;
 		u1 = u->next;
+		iopool_free (u);
+		readahead_free (u);
 		for (k1 = u->keys; k1; k1 = knext) {
 			knext = k1->next;
 			if (k1->fd)
@@ -6689,7 +7297,11 @@ void filesys_free_handles (void)
 			xfree (lr);
 		}
 		u->waitingrecords = NULL;
+		if (u->nr_cache_lookups)
+			write_log (_T("FS: unit %d: %lu of %lu a_inode lookups hit the index, %lu indexed\n"),
+				u->unit, u->nr_cache_hits, u->nr_cache_lookups, u->aino_hash_count);
 		free_all_ainos (u, &u->rootnode);
+		aino_hash_free (u);
 		u->rootnode.next = u->rootnode.prev = &u->rootnode;
 		u->aino_cache_size = 0;
 		xfree (u->newrootdir);
@@ -8483,6 +9095,7 @@ static uae_u8 *save_filesys_virtual (UnitInfo *ui, uae_u8 *dst)
 	int cnt, i, j;
 
 	write_log (_T("FSSAVE: '%s'\n"), ui->devname);
+	iopool_drain (u);
 	save_u32 (u->dosbase);
 	save_u32 (u->volume);
 	save_u32 (u->port);
@@ -0,0 +1,365 @@
+ /*
+  * UAE - The Un*x Amiga Emulator
+  *
+  * Equivalence test and micro-benchmark for the genblitter output
+  *
+  * Runs every generated blitdofast* function (all minterms, ascending,
+  * descending, fill and descending fill) against a copy of the generic
+  * per-word loops from blitter_dofast() and blitter_dofast_desc() with
+  * random channel enables, shifts, masks, modulos and sizes, and compares
+  * chip RAM and the bltinfo registers afterwards. genblitter_test.sh
+  * generates the functions, builds and runs this.
+  *
+  * With "bench" as the first argument it times both versions over a range
+  * of blit sizes instead.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef unsigned char uae_u8;
+typedef unsigned short uae_u16;
+typedef unsigned int uae_u32;
+typedef uae_u32 uaecptr;
+#define STATIC_INLINE static inline
+
+#include "blitter.h"
+
+#define CHIPSIZE 0x40000
+#define CHIPMASK (CHIPSIZE - 1)
+
+static uae_u8 chipram[CHIPSIZE];
+
+STATIC_INLINE uae_u32 chipmem_wget_indirect (uaecptr addr)
+{
+	addr &= CHIPMASK & ~1;
+	return (chipram[addr] << 8) | chipram[addr + 1];
+}
+STATIC_INLINE void chipmem_wput_indirect (uaecptr addr, uae_u32 w)
+{
+	addr &= CHIPMASK & ~1;
+	chipram[addr] = w >> 8;
+	chipram[addr + 1] = (uae_u8)w;
+}
+#define MW_MASK_BLITTER_D 0
+STATIC_INLINE void debug_wputpeekdma_chipram (uaecptr addr, uae_u32 w, uae_u32 mask, int reg) { }
+
+int log_blitter;
+struct bltinfo blt_info;
+uae_u8 blit_filltable[256][4][2];
+uae_u32 blit_masktable[BLITTER_MAX_WORDS];
+
+#include "blit.h"
+#include "blitfunc.inc"
+#include "blittable.inc"
+
+/* same as build_blitfilltable() in blitter.cpp */
+static void build_filltable (void)
+{
+	unsigned int d, fillmask;
+	int i;
+
+	for (i = 0; i < BLITTER_MAX_WORDS; i++)
+		blit_masktable[i] = 0xFFFF;
+
+	for (d = 0; d < 256; d++) {
+		for (i = 0; i < 4; i++) {
+			int fc = i & 1;
+			uae_u8 data = d;
+			for (fillmask = 1; fillmask != 0x100; fillmask <<= 1) {
+				uae_u16 tmp = data;
+				if (fc) {
+					if (i & 2)
+						data |= fillmask;
+					else
+						data ^= fillmask;
+				}
+				if (tmp & fillmask) fc = !fc;
+			}
+			blit_filltable[d][i][0] = data;
+			blit_filltable[d][i][1] = fc;
+		}
+	}
+}
+
+/* The generic loops of blitter_dofast() and blitter_dofast_desc(), keep in sync. */
+static void reference_blit (uaecptr bltadatptr, uaecptr bltbdatptr, uaecptr bltcdatptr, uaecptr bltddatptr,
+	uae_u8 mt, int desc, int blitfill, int blitife, int fcinit)
+{
+	int i, j;
+	int blitfc = fcinit;
+	uae_u32 blitbhold = blt_info.bltbhold;
+	uae_u32 preva = 0, prevb = 0;
+	uaecptr dstp = 0;
+	int dodst = 0;
+	int step = desc ? -1 : 1;
+
+	for (j = 0; j < blt_info.vblitsize; j++) {
+		blitfc = fcinit;
+		for (i = 0; i < blt_info.hblitsize; i++) {
+			uae_u32 bltadat, blitahold;
+			uae_u16 bltbdat;
+			if (bltadatptr) {
+				blt_info.bltadat = bltadat = chipmem_wget_indirect (bltadatptr);
+				bltadatptr += 2 * step;
+			} else
+				bltadat = blt_info.bltadat;
+			bltadat &= blit_masktable[i];
+			if (desc)
+				blitahold = (((uae_u32)bltadat << 16) | preva) >> blt_info.blitdownashift;
+			else
+				blitahold = (((uae_u32)preva << 16) | bltadat) >> blt_info.blitashift;
+			preva = bltadat;
+
+			if (bltbdatptr) {
+				blt_info.bltbdat = bltbdat = chipmem_wget_indirect (bltbdatptr);
+				bltbdatptr += 2 * step;
+				if (desc)
+					blitbhold = (((uae_u32)bltbdat << 16) | prevb) >> blt_info.blitdownbshift;
+				else
+					blitbhold = (((uae_u32)prevb << 16) | bltbdat) >> blt_info.blitbshift;
+				prevb = bltbdat;
+			}
+
+			if (bltcdatptr) {
+				if (desc)
+					blt_info.bltcdat = blt_info.bltbdat = chipmem_wget_indirect (bltcdatptr);
+				else
+					blt_info.bltcdat = chipmem_wget_indirect (bltcdatptr);
+				bltcdatptr += 2 * step;
+			}
+			if (dodst)
+				chipmem_wput_indirect (dstp, blt_info.bltddat);
+			blt_info.bltddat = blit_func (blitahold, blitbhold, blt_info.bltcdat, mt) & 0xFFFF;
+			if (blitfill) {
+				uae_u16 d = blt_info.bltddat;
+				int ifemode = blitife ? 2 : 0;
+				int fc1 = blit_filltable[d & 255][ifemode + blitfc][1];
+				blt_info.bltddat = (blit_filltable[d & 255][ifemode + blitfc][0]
+					+ (blit_filltable[d >> 8][ifemode + fc1][0] << 8));
+				blitfc = blit_filltable[d >> 8][ifemode + fc1][1];
+			}
+			if (blt_info.bltddat)
+				blt_info.blitzero = 0;
+			if (bltddatptr) {
+				dodst = 1;
+				dstp = bltddatptr;
+				bltddatptr += 2 * step;
+			}
+		}
+		if (bltadatptr)
+			bltadatptr += blt_info.bltamod * step;
+		if (bltbdatptr)
+			bltbdatptr += blt_info.bltbmod * step;
+		if (bltcdatptr)
+			bltcdatptr += blt_info.bltcmod * step;
+		if (bltddatptr)
+			bltddatptr += blt_info.bltdmod * step;
+	}
+	if (dodst)
+		chipmem_wput_indirect (dstp, blt_info.bltddat);
+	blt_info.bltbhold = blitbhold;
+	blt_info.blitfc = blitfc;
+}
+
+static blitter_func *generated_func (uae_u8 mt, int desc, int fill)
+{
+	if (fill)
+		return desc ? blitfunc_dofast_desc_fill[mt] : blitfunc_dofast_fill[mt];
+	return desc ? blitfunc_dofast_desc[mt] : blitfunc_dofast[mt];
+}
+
+struct blit_setup
+{
+	uaecptr pt[4];
+	uae_u8 mt;
+	int desc, fill, ife, fc;
+	struct bltinfo regs;
+};
+
+static uae_u32 rnd_state = 0x12345678;
+
+static uae_u32 rnd (void)
+{
+	/* xorshift32, same sequence on every host */
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+static void random_setup (struct blit_setup *s, uae_u8 mt, int desc, int fill)
+{
+	static const int widths[] = { 1, 2, 3, 5, 8, 20, 41 };
+	int i;
+
+	memset (s, 0, sizeof *s);
+	s->mt = mt;
+	s->desc = desc;
+	s->fill = fill;
+	s->ife = rnd () & 1;
+	s->fc = rnd () & 1;
+	s->regs.hblitsize = widths[rnd () % (sizeof widths / sizeof widths[0])];
+	s->regs.vblitsize = 1 + rnd () % 9;
+	s->regs.blitashift = rnd () & 15;
+	s->regs.blitbshift = rnd () & 15;
+	s->regs.blitdownashift = 16 - s->regs.blitashift;
+	s->regs.blitdownbshift = 16 - s->regs.blitbshift;
+	s->regs.bltafwm = (rnd () & 3) ? rnd () & 0xffff : 0xffff;
+	s->regs.bltalwm = (rnd () & 3) ? rnd () & 0xffff : 0xffff;
+	s->regs.bltadat = rnd () & 0xffff;
+	s->regs.bltbdat = rnd () & 0xffff;
+	s->regs.bltcdat = rnd () & 0xffff;
+	s->regs.bltddat = rnd () & 0xffff;
+	s->regs.bltbhold = rnd () & 0xffff;
+	s->regs.blitzero = 1;
+	s->regs.bltamod = ((int)(rnd () % 9) - 4) * 2;
+	s->regs.bltbmod = ((int)(rnd () % 9) - 4) * 2;
+	s->regs.bltcmod = ((int)(rnd () % 9) - 4) * 2;
+	s->regs.bltdmod = ((int)(rnd () % 9) - 4) * 2;
+	/* random channel enables, D sometimes overlapping a source */
+	for (i = 0; i < 4; i++) {
+		if (rnd () & 1)
+			s->pt[i] = 0x1000 + (rnd () % 0x3c000 & ~1);
+	}
+	if (s->pt[3] && (rnd () & 3) == 0)
+		s->pt[3] = s->pt[rnd () % 3] ? s->pt[rnd () % 3] : s->pt[3];
+}
+
+static void run_setup (const struct blit_setup *s, const uae_u8 *mem, int generated)
+{
+	memcpy (chipram, mem, CHIPSIZE);
+	blt_info = s->regs;
+	blit_masktable[0] = blt_info.bltafwm;
+	blit_masktable[blt_info.hblitsize - 1] &= blt_info.bltalwm;
+	if (generated) {
+		blt_info.blitfc = s->fc;
+		blt_info.blitife = s->ife;
+		generated_func (s->mt, s->desc, s->fill) (s->pt[0], s->pt[1], s->pt[2], s->pt[3], &blt_info);
+	} else {
+		reference_blit (s->pt[0], s->pt[1], s->pt[2], s->pt[3], s->mt, s->desc, s->fill, s->ife, s->fc);
+	}
+	blit_masktable[0] = 0xFFFF;
+	blit_masktable[blt_info.hblitsize - 1] = 0xFFFF;
+}
+
+static int compare_regs (const struct bltinfo *a, const struct bltinfo *b, int fill)
+{
+	return a->bltadat == b->bltadat && a->bltbdat == b->bltbdat && a->bltcdat == b->bltcdat
+		&& a->bltddat == b->bltddat && a->bltbhold == b->bltbhold && a->blitzero == b->blitzero
+		&& (!fill || a->blitfc == b->blitfc);
+}
+
+static int equivalence_test (int iterations)
+{
+	static uae_u8 mem[CHIPSIZE], refmem[CHIPSIZE];
+	int failures = 0;
+	long blits = 0;
+
+	for (int i = 0; i < CHIPSIZE; i++)
+		mem[i] = rnd ();
+	for (int mt = 0; mt < 256; mt++) {
+		for (int variant = 0; variant < 4; variant++) {
+			int desc = variant & 1, fill = variant >> 1;
+			int bad = 0;
+			for (int n = 0; n < iterations && !bad; n++) {
+				struct blit_setup s;
+				struct bltinfo refregs;
+
+				random_setup (&s, mt, desc, fill);
+				run_setup (&s, mem, 0);
+				memcpy (refmem, chipram, CHIPSIZE);
+				refregs = blt_info;
+				run_setup (&s, mem, 1);
+				blits++;
+				if (memcmp (refmem, chipram, CHIPSIZE) || !compare_regs (&refregs, &blt_info, fill)) {
+					printf ("minterm %02x%s%s: mismatch, %dx%d A=%x B=%x C=%x D=%x\n",
+						mt, desc ? " desc" : "", fill ? " fill" : "",
+						s.regs.hblitsize, s.regs.vblitsize, s.pt[0], s.pt[1], s.pt[2], s.pt[3]);
+					printf ("  reference: adat %04x bdat %04x cdat %04x ddat %04x bhold %04x zero %d fc %d\n",
+						refregs.bltadat, refregs.bltbdat, refregs.bltcdat, refregs.bltddat, refregs.bltbhold, refregs.blitzero, refregs.blitfc);
+					printf ("  generated: adat %04x bdat %04x cdat %04x ddat %04x bhold %04x zero %d fc %d\n",
+						blt_info.bltadat, blt_info.bltbdat, blt_info.bltcdat, blt_info.bltddat, blt_info.bltbhold, blt_info.blitzero, blt_info.blitfc);
+					bad = 1;
+				}
+			}
+			failures += bad;
+		}
+	}
+	if (failures) {
+		printf ("genblitter: %d of 1024 functions differ from the generic loop\n", failures);
+		return 1;
+	}
+	printf ("genblitter: %ld blits, all 1024 functions match the generic loop\n", blits);
+	return 0;
+}
+
+static double bench_one (const struct blit_setup *s, int generated, long words)
+{
+	long loops = words / (s->regs.hblitsize * s->regs.vblitsize) + 1;
+	clock_t start = clock ();
+
+	for (long i = 0; i < loops; i++) {
+		blt_info = s->regs;
+		if (generated) {
+			blt_info.blitfc = s->fc;
+			blt_info.blitife = s->ife;
+			generated_func (s->mt, s->desc, s->fill) (s->pt[0], s->pt[1], s->pt[2], s->pt[3], &blt_info);
+		} else {
+			reference_blit (s->pt[0], s->pt[1], s->pt[2], s->pt[3], s->mt, s->desc, s->fill, s->ife, s->fc);
+		}
+	}
+	double secs = (double)(clock () - start) / CLOCKS_PER_SEC;
+	return secs > 0 ? loops * (double)(s->regs.hblitsize * s->regs.vblitsize) / secs / 1000000.0 : 0;
+}
+
+static int benchmark (void)
+{
+	static const struct { int w, h; } sizes[] = {
+		{ 1, 1 }, { 2, 16 }, { 4, 64 }, { 20, 200 }, { 40, 256 }, { 80, 512 }, { 128, 1024 }
+	};
+	static const struct { uae_u8 mt; int mask; int fill; const char *name; } ops[] = {
+		{ 0xf0, 0x9, 0, "copy A->D" },
+		{ 0xca, 0xf, 0, "cookie cut" },
+		{ 0x0a, 0x5, 1, "fill" },
+		{ 0x00, 0x8, 0, "clear" }
+	};
+
+	for (int i = 0; i < CHIPSIZE; i++)
+		chipram[i] = rnd ();
+	printf ("%-12s %9s %12s %12s %7s\n", "minterm", "size", "generic", "generated", "ratio");
+	for (int o = 0; o < sizeof ops / sizeof ops[0]; o++) {
+		for (int z = 0; z < sizeof sizes / sizeof sizes[0]; z++) {
+			struct blit_setup s;
+			double ref, gen;
+
+			memset (&s, 0, sizeof s);
+			s.mt = ops[o].mt;
+			s.fill = ops[o].fill;
+			s.regs.hblitsize = sizes[z].w;
+			s.regs.vblitsize = sizes[z].h;
+			s.regs.blitashift = 4;
+			s.regs.blitdownashift = 12;
+			s.regs.bltafwm = s.regs.bltalwm = 0xffff;
+			for (int c = 0; c < 4; c++) {
+				if (ops[o].mask & (1 << c))
+					s.pt[c] = 0x1000 + c * 0x8000;
+			}
+			ref = bench_one (&s, 0, 20000000);
+			gen = bench_one (&s, 1, 20000000);
+			printf ("%-12s %4dx%-4d %8.1f Mw/s %8.1f Mw/s %6.2fx\n", ops[o].name, sizes[z].w, sizes[z].h,
+				ref, gen, ref > 0 ? gen / ref : 0);
+		}
+	}
+	return 0;
+}
+
+int main (int argc, char **argv)
+{
+	build_filltable ();
+	if (argc > 1 && !strcmp (argv[1], "bench"))
+		return benchmark ();
+	return equivalence_test (argc > 1 ? atoi (argv[1]) : 200);
+}
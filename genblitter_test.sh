@@ -0,0 +1,20 @@
+#!/bin/sh
+# Generates the blitter functions with genblitter, then checks them against
+# the generic blitter loop (genblitter_test.cpp).
+# Usage: genblitter_test.sh [iterations | bench]
+
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=${TMPDIR:-/tmp}/genblitter_test.$$
+
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+# genblitter only needs the standard headers, not the emulator's sysconfig.h
+: > "$TMP/sysconfig.h"
+$CXX -O2 -I"$TMP" -I"$DIR/include" -o "$TMP/genblitter" "$DIR/genblitter.cpp" "$DIR/blitops.cpp" || exit 1
+"$TMP/genblitter" i > "$TMP/blit.h" || exit 1
+"$TMP/genblitter" f | grep -v '^#include' > "$TMP/blitfunc.inc" || exit 1
+"$TMP/genblitter" t | grep -v '^#include' > "$TMP/blittable.inc" || exit 1
+$CXX -O2 -I"$TMP" -I"$DIR/include" -o "$TMP/genblitter_test" "$DIR/genblitter_test.cpp" || exit 1
+"$TMP/genblitter_test" "$@"
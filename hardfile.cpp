@@ -446,21 +446,285 @@ static uae_u32 vhd_checksum (uae_u8 *p, int offset)
 static int hdf_write2 (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len);
 static int hdf_read2 (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len);
 
+/* Write-back LRU block cache. Small requests go through the cache,
+ * large ones go directly to the image but still see dirty cached data.
+ */
+
+#define HDF_CACHE_READAHEAD 8
+#define HDF_CACHE_MAX_REQUEST (4 * HDF_CACHE_BLOCK_SIZE)
+
 static void hdf_init_cache (struct hardfiledata *hfd)
 {
+	memset (hfd->bcache, 0, sizeof hfd->bcache);
+	hfd->bcache_tick = 0;
+	hfd->bcache_next = ~0;
+	hfd->bcache_hits = 0;
+	hfd->bcache_misses = 0;
+}
+
+static void hdf_free_cache (struct hardfiledata *hfd)
+{
+	if (hfd->bcache_hits || hfd->bcache_misses)
+		write_log (_T("HDF cache: %d hits, %d misses\n"), hfd->bcache_hits, hfd->bcache_misses);
+	for (int i = 0; i < MAX_HDF_CACHE_BLOCKS; i++)
+		xfree (hfd->bcache[i].data);
+	hdf_init_cache (hfd);
+}
+
+static int hdf_cache_cmp (const void *a, const void *b)
+{
+	const struct hdf_cache *c1 = *(const struct hdf_cache**)a;
+	const struct hdf_cache *c2 = *(const struct hdf_cache**)b;
+	if (c1->block == c2->block)
+		return 0;
+	return c1->block < c2->block ? -1 : 1;
+}
+
+/* Write all dirty blocks back. Blocks that fail to write stay dirty,
+ * returns false if any did. */
+bool hdf_flush_cache (struct hardfiledata *hfd)
+{
+	struct hdf_cache *dirty[MAX_HDF_CACHE_BLOCKS];
+	int i, j, k, cnt;
+	uae_u8 *buf;
+	bool ok = true;
+
+	cnt = 0;
+	for (i = 0; i < MAX_HDF_CACHE_BLOCKS; i++) {
+		struct hdf_cache *c = &hfd->bcache[i];
+		if (c->valid && c->dirty)
+			dirty[cnt++] = c;
+	}
+	if (!cnt)
+		return true;
+	qsort (dirty, cnt, sizeof (struct hdf_cache*), hdf_cache_cmp);
+	buf = xmalloc (uae_u8, cnt * HDF_CACHE_BLOCK_SIZE);
+	for (i = 0; i < cnt; i = j) {
+		// merge adjacent dirty blocks to single write
+		for (j = i + 1; j < cnt && dirty[j]->block == dirty[j - 1]->block + 1; j++);
+		if (j - i > 1 && buf) {
+			int len = (j - i) * HDF_CACHE_BLOCK_SIZE;
+			for (k = i; k < j; k++)
+				memcpy (buf + (k - i) * HDF_CACHE_BLOCK_SIZE, dirty[k]->data, HDF_CACHE_BLOCK_SIZE);
+			if (hdf_write2 (hfd, buf, dirty[i]->block * HDF_CACHE_BLOCK_SIZE, len) != len) {
+				write_log (_T("HDF cache: write error at block %llu (%d)\n"), dirty[i]->block, j - i);
+				ok = false;
+				continue;
+			}
+			for (k = i; k < j; k++)
+				dirty[k]->dirty = false;
+		} else {
+			for (k = i; k < j; k++) {
+				if (hdf_write2 (hfd, dirty[k]->data, dirty[k]->block * HDF_CACHE_BLOCK_SIZE, HDF_CACHE_BLOCK_SIZE) != HDF_CACHE_BLOCK_SIZE) {
+					write_log (_T("HDF cache: write error at block %llu\n"), dirty[k]->block);
+					ok = false;
+					continue;
+				}
+				dirty[k]->dirty = false;
+			}
+		}
+	}
+	xfree (buf);
+	return ok;
+}
+
+static bool hdf_cache_usable (struct hardfiledata *hfd, uae_u64 offset, int len)
+{
+	if (len <= 0 || len > HDF_CACHE_MAX_REQUEST)
+		return false;
+	return (offset + len + HDF_CACHE_BLOCK_SIZE - 1) / HDF_CACHE_BLOCK_SIZE * HDF_CACHE_BLOCK_SIZE <= hfd->virtsize;
+}
+
+static struct hdf_cache *hdf_cache_find (struct hardfiledata *hfd, uae_u64 block)
+{
+	for (int i = 0; i < MAX_HDF_CACHE_BLOCKS; i++) {
+		struct hdf_cache *c = &hfd->bcache[i];
+		if (c->valid && c->block == block)
+			return c;
+	}
+	return NULL;
+}
+
+static struct hdf_cache *hdf_cache_alloc (struct hardfiledata *hfd, uae_u64 block)
+{
+	struct hdf_cache *lru = NULL;
+
+	for (int i = 0; i < MAX_HDF_CACHE_BLOCKS; i++) {
+		struct hdf_cache *c = &hfd->bcache[i];
+		if (!c->valid) {
+			lru = c;
+			break;
+		}
+		if (!lru || (int)(c->lastaccess - lru->lastaccess) < 0)
+			lru = c;
+	}
+	if (lru->valid && lru->dirty) {
+		// never drop data that could not be written back
+		if (!hdf_flush_cache (hfd) && lru->dirty)
+			return NULL;
+	}
+	if (!lru->data) {
+		lru->data = xmalloc (uae_u8, HDF_CACHE_BLOCK_SIZE);
+		if (!lru->data)
+			return NULL;
+	}
+	lru->valid = true;
+	lru->dirty = false;
+	lru->block = block;
+	lru->readcount = 0;
+	lru->writecount = 0;
+	lru->lastaccess = hfd->bcache_tick++;
+	return lru;
+}
+
+/* read missing block, plus following blocks if access looks sequential */
+static struct hdf_cache *hdf_cache_fill (struct hardfiledata *hfd, uae_u64 block)
+{
+	struct hdf_cache *first = NULL;
+	uae_u8 *buf;
+	int i, cnt, len;
+
+	cnt = 1;
+	if (block == hfd->bcache_next) {
+		while (cnt < HDF_CACHE_READAHEAD && (block + cnt + 1) * HDF_CACHE_BLOCK_SIZE <= hfd->virtsize && !hdf_cache_find (hfd, block + cnt))
+			cnt++;
+	}
+	buf = xmalloc (uae_u8, cnt * HDF_CACHE_BLOCK_SIZE);
+	if (!buf)
+		return NULL;
+	len = hdf_read2 (hfd, buf, block * HDF_CACHE_BLOCK_SIZE, cnt * HDF_CACHE_BLOCK_SIZE);
+	cnt = len > 0 ? len / HDF_CACHE_BLOCK_SIZE : 0;
+	for (i = 0; i < cnt; i++) {
+		struct hdf_cache *c = hdf_cache_alloc (hfd, block + i);
+		if (!c)
+			break;
+		memcpy (c->data, buf + i * HDF_CACHE_BLOCK_SIZE, HDF_CACHE_BLOCK_SIZE);
+		if (!first)
+			first = c;
+	}
+	if (first)
+		first->lastaccess = hfd->bcache_tick++;
+	xfree (buf);
+	return first;
+}
+
+static int hdf_cache_bypass_read (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len)
+{
+	int v = hdf_read2 (hfd, buffer, offset, len);
+	if (v <= 0)
+		return v;
+	// not yet flushed data must win
+	for (int i = 0; i < MAX_HDF_CACHE_BLOCKS; i++) {
+		struct hdf_cache *c = &hfd->bcache[i];
+		uae_u64 start, end;
+		if (!c->valid || !c->dirty)
+			continue;
+		start = c->block * HDF_CACHE_BLOCK_SIZE;
+		end = start + HDF_CACHE_BLOCK_SIZE;
+		if (start < offset)
+			start = offset;
+		if (end > offset + v)
+			end = offset + v;
+		if (start < end)
+			memcpy ((uae_u8*)buffer + (start - offset), c->data + (start - c->block * HDF_CACHE_BLOCK_SIZE), (int)(end - start));
+	}
+	return v;
 }
-static void hdf_flush_cache (struct hardfiledata *hdf)
+
+static int hdf_cache_bypass_write (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len)
 {
+	int v = hdf_write2 (hfd, buffer, offset, len);
+	if (v != len)
+		return v;
+	for (int i = 0; i < MAX_HDF_CACHE_BLOCKS; i++) {
+		struct hdf_cache *c = &hfd->bcache[i];
+		uae_u64 start, end;
+		if (!c->valid)
+			continue;
+		start = c->block * HDF_CACHE_BLOCK_SIZE;
+		end = start + HDF_CACHE_BLOCK_SIZE;
+		if (start < offset)
+			start = offset;
+		if (end > offset + len)
+			end = offset + len;
+		if (start < end)
+			memcpy (c->data + (start - c->block * HDF_CACHE_BLOCK_SIZE), (uae_u8*)buffer + (start - offset), (int)(end - start));
+	}
+	return v;
 }
 
 static int hdf_cache_read (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len)
 {
-	return hdf_read2 (hfd, buffer, offset, len);
+	uae_u8 *p = (uae_u8*)buffer;
+	int got = 0;
+
+	if (!hdf_cache_usable (hfd, offset, len))
+		return hdf_cache_bypass_read (hfd, buffer, offset, len);
+	while (got < len) {
+		uae_u64 block = (offset + got) / HDF_CACHE_BLOCK_SIZE;
+		int boffset = (int)((offset + got) % HDF_CACHE_BLOCK_SIZE);
+		int size = HDF_CACHE_BLOCK_SIZE - boffset;
+		struct hdf_cache *c;
+
+		if (size > len - got)
+			size = len - got;
+		c = hdf_cache_find (hfd, block);
+		if (c) {
+			hfd->bcache_hits++;
+			c->lastaccess = hfd->bcache_tick++;
+		} else {
+			hfd->bcache_misses++;
+			c = hdf_cache_fill (hfd, block);
+			if (!c) {
+				int v = hdf_cache_bypass_read (hfd, p + got, offset + got, len - got);
+				return v > 0 ? got + v : got;
+			}
+		}
+		memcpy (p + got, c->data + boffset, size);
+		c->readcount++;
+		got += size;
+	}
+	hfd->bcache_next = (offset + len + HDF_CACHE_BLOCK_SIZE - 1) / HDF_CACHE_BLOCK_SIZE;
+	return len;
 }
 
 static int hdf_cache_write (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len)
 {
-	return hdf_write2 (hfd, buffer, offset, len);
+	uae_u8 *p = (uae_u8*)buffer;
+	int got = 0;
+
+	if (hfd->ci.readonly || !hdf_cache_usable (hfd, offset, len))
+		return hdf_cache_bypass_write (hfd, buffer, offset, len);
+	while (got < len) {
+		uae_u64 block = (offset + got) / HDF_CACHE_BLOCK_SIZE;
+		int boffset = (int)((offset + got) % HDF_CACHE_BLOCK_SIZE);
+		int size = HDF_CACHE_BLOCK_SIZE - boffset;
+		struct hdf_cache *c;
+
+		if (size > len - got)
+			size = len - got;
+		c = hdf_cache_find (hfd, block);
+		if (c) {
+			hfd->bcache_hits++;
+			c->lastaccess = hfd->bcache_tick++;
+		} else {
+			hfd->bcache_misses++;
+			// partial block needs old contents first
+			if (size == HDF_CACHE_BLOCK_SIZE)
+				c = hdf_cache_alloc (hfd, block);
+			else
+				c = hdf_cache_fill (hfd, block);
+			if (!c) {
+				int v = hdf_cache_bypass_write (hfd, p + got, offset + got, len - got);
+				return v > 0 ? got + v : got;
+			}
+		}
+		memcpy (c->data + boffset, p + got, size);
+		c->dirty = true;
+		c->writecount++;
+		got += size;
+	}
+	return len;
 }
 
 int hdf_open (struct hardfiledata *hfd, const TCHAR *pname)
@@ -471,6 +735,7 @@ int hdf_open (struct hardfiledata *hfd, const TCHAR *pname)
 
 	if ((!pname || pname[0] == 0) && hfd->ci.rootdir[0] == 0)
 		return 0;
+	hdf_init_cache (hfd);
 	hfd->adide = 0;
 	hfd->byteswap = 0;
 	hfd->hfd_type = 0;
@@ -575,7 +840,6 @@ int hdf_open (struct hardfiledata *hfd, const TCHAR *pname)
 	write_log (_T("HDF is VHD %s image, virtual size=%lldK (%llx %lld)\n"),
 		hfd->hfd_type == HFD_VHD_FIXED ? _T("fixed") : _T("dynamic"),
 		hfd->virtsize / 1024, hfd->virtsize, hfd->virtsize);
-	hdf_init_cache (hfd);
 	return 1;
 nonvhd:
 	hfd->hfd_type = 0;
@@ -592,6 +856,7 @@ int hdf_open (struct hardfiledata *hfd)
 void hdf_close (struct hardfiledata *hfd)
 {
 	hdf_flush_cache (hfd);
+	hdf_free_cache (hfd);
 	hdf_close_target (hfd);
 #ifdef WITH_CHD
 	if (hfd->hfd_type == HFD_CHD_OTHER) {
@@ -616,6 +881,8 @@ void hdf_close (struct hardfiledata *hfd)
 
 int hdf_dup (struct hardfiledata *dhfd, const struct hardfiledata *shfd)
 {
+	hdf_flush_cache ((struct hardfiledata*)shfd);
+	hdf_init_cache (dhfd);
 	return hdf_dup_target (dhfd, shfd);
 }
 
@@ -1429,6 +1696,8 @@ int scsi_hd_emulate (struct hardfiledata *hfd, struct hd_hardfiledata *hdhfd, ua
 	case 0x35: /* SYNCRONIZE CACHE (10) */
 		if (nodisk (hfd))
 			goto nodisk;
+		if (!hdf_flush_cache (hfd))
+			goto writeerr;
 		scsi_len = 0;
 		break;
 	case 0xa8: /* READ (12) */
@@ -1503,6 +1772,13 @@ miscompare:
 		s[12] = 0x1d; /* MISCOMPARE DURING VERIFY OPERATION */
 		ls = 0x12;
 		break;
+writeerr:
+		status = 2; /* CHECK CONDITION */
+		s[0] = 0x70;
+		s[2] = 3; /* MEDIUM ERROR */
+		s[12] = 0x0c; /* WRITE ERROR */
+		ls = 0x12;
+		break;
 	}
 scsi_done:
 
@@ -1959,8 +2235,12 @@ static uae_u32 hardfile_do_io (struct hardfiledata *hfd, struct hardfileprivdata
 		actual = hfd->drive_empty ? 1 :0;
 		break;
 
-		/* Some commands that just do nothing and return zero */
 	case CMD_UPDATE:
+		if (!hdf_flush_cache (hfd))
+			error = 20; /* not specified */
+		break;
+
+		/* Some commands that just do nothing and return zero */
 	case CMD_CLEAR:
 	case CMD_MOTOR:
 	case CMD_SEEK:
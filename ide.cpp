@@ -879,7 +879,12 @@ static void ide_do_command (struct ide_hdf *ide, uae_u8 cmd)
 			ide_fail (ide);
 		} else if (cmd == 0x70) { /* seek */
 			ide_interrupt (ide);
-		} else if (cmd == 0xe0 || cmd == 0xe1 || cmd == 0xe7 || cmd == 0xea) { /* standby now/idle/flush cache/flush cache ext */
+		} else if (cmd == 0xe7 || cmd == 0xea) { /* flush cache/flush cache ext */
+			if (!hdf_flush_cache (&ide->hdhfd.hfd))
+				ide_fail (ide);
+			else
+				ide_interrupt (ide);
+		} else if (cmd == 0xe0 || cmd == 0xe1) { /* standby now/idle */
 			ide_interrupt (ide);
 		} else if (cmd == 0xe5) { /* check power mode */
 			ide->regs.ide_nsector = 0xff;
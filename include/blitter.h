@@ -14,6 +14,7 @@ struct bltinfo {
     int vblitsize, hblitsize;
     int bltamod, bltbmod, bltcmod, bltdmod;
     int got_cycle;
+    int blitfc, blitife; /* fill state for blitfunc_dofast*_fill */
 };
 
 extern enum blitter_states {
@@ -54,7 +55,11 @@ typedef void blitter_func(uaecptr, uaecptr, uaecptr, uaecptr, struct bltinfo *);
 
 extern blitter_func * const blitfunc_dofast[256];
 extern blitter_func * const blitfunc_dofast_desc[256];
+extern blitter_func * const blitfunc_dofast_fill[256];
+extern blitter_func * const blitfunc_dofast_desc_fill[256];
+extern uae_u8 blit_filltable[256][4][2];
 extern uae_u32 blit_masktable[BLITTER_MAX_WORDS];
+extern int log_blitter;
 
 #define BLIT_MODE_IMMEDIATE -1
 #define BLIT_MODE_APPROXIMATE 0
@@ -193,6 +193,34 @@ extern struct mmu_atc_line mmu_atc_array[ATC_TYPE][ATC_WAYS][ATC_SLOTS];
 /* Last matched ATC index, next lookup starts from this index as an optimization */
 extern int mmu_atc_ways;
 
+/*
+ * Direct mapped cache in front of the ATC, one slot per 4k of logical
+ * address space, separate for instruction/data and read/write. Only pages
+ * that hit in the ATC, did not match a TTR and map to plain memory are
+ * entered, a hit is a tag compare and a host memory access.
+ * Tag is logical 4k page | 2 if supervisor | 1 (valid).
+ */
+#define MMU_FAST_SLOTS 256
+
+struct mmu_fast_line {
+	uaecptr tag;
+	uae_u8 *host; // host address of the 4k logical page
+};
+
+extern struct mmu_fast_line mmu_fast_array[ATC_TYPE][2][MMU_FAST_SLOTS];
+
+extern void mmu_flush_fast(void);
+extern void mmu_flush_fast_page(uaecptr addr);
+extern void mmu_fast_fill(uaecptr addr, bool data, bool write, struct mmu_atc_line *cl);
+
+static ALWAYS_INLINE uae_u8 *mmu_fast_lookup(uaecptr addr, bool data, bool write)
+{
+	struct mmu_fast_line *fl = &mmu_fast_array[data][write][(addr >> 12) & (MMU_FAST_SLOTS - 1)];
+	if (fl->tag != ((addr & ~0xfff) | (mmu_is_super >> 30) | 1))
+		return NULL;
+	return fl->host + (addr & 0xfff);
+}
+
 /*
  * mmu access is a 4 step process:
  * if mmu is not enabled just read physical
@@ -226,6 +254,8 @@ static ALWAYS_INLINE bool mmu_lookup(uaecptr addr, bool data, bool write,
 	}
 	// we select a random way to void
 	*cl=&mmu_atc_array[data][way_miss%ATC_WAYS][index];
+	if ((*cl)->valid)
+		mmu_flush_fast_page(((*cl)->tag << 1) | (index << (mmu_pagesize_8k ? 13 : 12)));
 	(*cl)->tag = tag;
 	way_miss++;
 	return false;
@@ -259,6 +289,8 @@ static ALWAYS_INLINE bool mmu_user_lookup(uaecptr addr, bool super, bool data,
 	}
 	// we select a random way to void
 	*cl=&mmu_atc_array[data][way_miss%ATC_WAYS][index];
+	if ((*cl)->valid)
+		mmu_flush_fast_page(((*cl)->tag << 1) | (index << (mmu_pagesize_8k ? 13 : 12)));
 	(*cl)->tag = tag;
 	way_miss++;
 	return false;
@@ -399,105 +431,148 @@ extern void mmu_put_move16(uaecptr addr, uae_u32 *val, bool data, int size);
 static ALWAYS_INLINE uae_u32 mmu_get_long(uaecptr addr, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, data, false);
 
+	if (p)
+		return do_get_mem_long((uae_u32*)p);
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,regs.s != 0,data,rmw)!=TTR_NO_MATCH))
 		return x_phys_get_long(addr);
-	if (likely(mmu_lookup(addr, data, false, &cl)))
+	if (likely(mmu_lookup(addr, data, false, &cl))) {
+		mmu_fast_fill(addr, data, false, cl);
 		return x_phys_get_long(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_long_slow(addr, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE uae_u32 mmu_get_ilong(uaecptr addr, int size)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, false, false);
 
+	if (p)
+		return do_get_mem_long((uae_u32*)p);
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr, regs.s != 0, false, false) != TTR_NO_MATCH))
 		return x_phys_get_ilong(addr);
-	if (likely(mmu_lookup(addr, false, false, &cl)))
+	if (likely(mmu_lookup(addr, false, false, &cl))) {
+		mmu_fast_fill(addr, false, false, cl);
 		return x_phys_get_ilong(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_ilong_slow(addr, regs.s != 0, size, cl);
 }
 
 static ALWAYS_INLINE uae_u16 mmu_get_word(uaecptr addr, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, data, false);
 
+	if (p)
+		return do_get_mem_word((uae_u16*)p);
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,regs.s != 0,data,rmw)!=TTR_NO_MATCH))
 		return x_phys_get_word(addr);
-	if (likely(mmu_lookup(addr, data, false, &cl)))
+	if (likely(mmu_lookup(addr, data, false, &cl))) {
+		mmu_fast_fill(addr, data, false, cl);
 		return x_phys_get_word(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_word_slow(addr, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE uae_u16 mmu_get_iword(uaecptr addr, int size)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, false, false);
 
+	if (p)
+		return do_get_mem_word((uae_u16*)p);
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr, regs.s != 0, false, false) != TTR_NO_MATCH))
 		return x_phys_get_iword(addr);
-	if (likely(mmu_lookup(addr, false, false, &cl)))
+	if (likely(mmu_lookup(addr, false, false, &cl))) {
+		mmu_fast_fill(addr, false, false, cl);
 		return x_phys_get_iword(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_iword_slow(addr, regs.s != 0, size, cl);
 }
 
 static ALWAYS_INLINE uae_u8 mmu_get_byte(uaecptr addr, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, data, false);
 
+	if (p)
+		return *p;
 	//                                       addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,regs.s != 0,data,rmw)!=TTR_NO_MATCH))
 		return x_phys_get_byte(addr);
-	if (likely(mmu_lookup(addr, data, false, &cl)))
+	if (likely(mmu_lookup(addr, data, false, &cl))) {
+		mmu_fast_fill(addr, data, false, cl);
 		return x_phys_get_byte(mmu_get_real_address(addr, cl));
+	}
 	return mmu_get_byte_slow(addr, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE void mmu_put_long(uaecptr addr, uae_u32 val, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, data, true);
 
+	if (p) {
+		do_put_mem_long((uae_u32*)p, val);
+		return;
+	}
 	//                                        addr,super,data
 	if ((!regs.mmu_enabled) || mmu_match_ttr_write(addr,regs.s != 0,data,val,size,rmw)==TTR_OK_MATCH) {
 		x_phys_put_long(addr,val);
 		return;
 	}
-	if (likely(mmu_lookup(addr, data, true, &cl)))
+	if (likely(mmu_lookup(addr, data, true, &cl))) {
+		mmu_fast_fill(addr, data, true, cl);
 		x_phys_put_long(mmu_get_real_address(addr, cl), val);
-	else
+	} else
 		mmu_put_long_slow(addr, val, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE void mmu_put_word(uaecptr addr, uae_u16 val, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, data, true);
 
+	if (p) {
+		do_put_mem_word((uae_u16*)p, val);
+		return;
+	}
 	//                                        addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr_write(addr,regs.s != 0,data,val,size,rmw)==TTR_OK_MATCH)) {
 		x_phys_put_word(addr,val);
 		return;
 	}
-	if (likely(mmu_lookup(addr, data, true, &cl)))
+	if (likely(mmu_lookup(addr, data, true, &cl))) {
+		mmu_fast_fill(addr, data, true, cl);
 		x_phys_put_word(mmu_get_real_address(addr, cl), val);
-	else
+	} else
 		mmu_put_word_slow(addr, val, regs.s != 0, data, size, rmw, cl);
 }
 
 static ALWAYS_INLINE void mmu_put_byte(uaecptr addr, uae_u8 val, bool data, int size, bool rmw)
 {
 	struct mmu_atc_line *cl;
+	uae_u8 *p = mmu_fast_lookup(addr, data, true);
 
+	if (p) {
+		*p = val;
+		return;
+	}
 	//                                        addr,super,data
 	if ((!regs.mmu_enabled) || (mmu_match_ttr_write(addr,regs.s != 0,data,val,size,rmw)==TTR_OK_MATCH)) {
 		x_phys_put_byte(addr,val);
 		return;
 	}
-	if (likely(mmu_lookup(addr, data, true, &cl)))
+	if (likely(mmu_lookup(addr, data, true, &cl))) {
+		mmu_fast_fill(addr, data, true, cl);
 		x_phys_put_byte(mmu_get_real_address(addr, cl), val);
-	else
+	} else
 		mmu_put_byte_slow(addr, val, regs.s != 0, data, size, rmw, cl);
 }
 
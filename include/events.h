@@ -63,7 +63,7 @@ enum {
 
 enum {
     ev2_blitter, ev2_disk, ev2_misc,
-    ev2_max = 12
+    ev2_initial = 12
 };
 
 extern int pissoff_value;
@@ -73,7 +73,9 @@ extern signed long pissoff;
 #define do_cycles do_cycles_slow
 
 extern struct ev eventtab[ev_max];
-extern struct ev2 eventtab2[ev2_max];
+extern struct ev2 *eventtab2;
+extern struct ev2 eventtab2_static[ev2_initial];
+extern int ev2_max;
 
 extern volatile bool vblank_found_chipset;
 extern volatile bool vblank_found_rtg;
@@ -128,6 +130,7 @@ STATIC_INLINE bool cycles_in_range (unsigned long endcycles)
 }
 
 extern void MISC_handler (void);
+extern void event2_clear (void);
 extern void event2_newevent_xx (int no, evt t, uae_u32 data, evfunc2 func);
 
 STATIC_INLINE void event2_newevent_x (int no, evt t, uae_u32 data, evfunc2 func)
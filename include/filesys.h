@@ -12,6 +12,7 @@
 struct hardfilehandle;
 
 #define MAX_HDF_CACHE_BLOCKS 128
+#define HDF_CACHE_BLOCK_SIZE 4096
 #define MAX_SCSI_SENSE 36
 struct hdf_cache
 {
@@ -21,7 +22,7 @@ struct hdf_cache
 	bool dirty;
 	int readcount;
 	int writecount;
-	time_t lastaccess;
+	uae_u32 lastaccess;
 };
 
 struct hardfiledata {
@@ -65,6 +66,9 @@ struct hardfiledata {
     TCHAR *emptyname;
 
 	struct hdf_cache bcache[MAX_HDF_CACHE_BLOCKS];
+	uae_u32 bcache_tick;
+	uae_u64 bcache_next;
+	int bcache_hits, bcache_misses;
 	uae_u8 scsi_sense[MAX_SCSI_SENSE];
 
 	struct uaedev_config_info delayedci;
@@ -127,6 +131,7 @@ extern int hdf_open (struct hardfiledata *hfd);
 extern int hdf_open (struct hardfiledata *hfd, const TCHAR *altname);
 extern int hdf_dup (struct hardfiledata *dhfd, const struct hardfiledata *shfd);
 extern void hdf_close (struct hardfiledata *hfd);
+extern bool hdf_flush_cache (struct hardfiledata *hfd);
 extern int hdf_read_rdb (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len);
 extern int hdf_read (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len);
 extern int hdf_write (struct hardfiledata *hfd, void *buffer, uae_u64 offset, int len);
@@ -63,6 +63,9 @@ struct virtualfilesysobject
 	int size;
 };
 
+/* uniq, parent+aname and parent+nname lookup indexes */
+#define AINO_HASH_MAX 3
+
 /* AmigaOS "keys" */
 typedef struct a_inode_struct {
 #ifdef AINO_DEBUG
@@ -109,6 +112,9 @@ typedef struct a_inode_struct {
     unsigned int mountcount;
 	uae_u64 uniq_external;
 	struct virtualfilesysobject *vfso;
+	/* Per unit lookup index chains, see AINO_HASH_MAX.  */
+	struct a_inode_struct *hashnext[AINO_HASH_MAX];
+	uae_u32 hashval[AINO_HASH_MAX];
 #ifdef AINO_DEBUG
     uae_u32 checksum2;
 #endif
@@ -128,6 +134,7 @@ extern a_inode *fsdb_lookup_aino_aname (a_inode *base, const TCHAR *);
 extern a_inode *fsdb_lookup_aino_nname (a_inode *base, const TCHAR *);
 extern int fsdb_exists (const TCHAR *nname);
 extern int same_aname (const TCHAR *an1, const TCHAR *an2);
+extern uae_u32 aname_hash (uae_u32 h, const TCHAR *an);
 
 /* Filesystem-dependent functions.  */
 extern int fsdb_name_invalid (const TCHAR *n);
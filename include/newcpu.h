@@ -626,11 +626,13 @@ extern cpuop_func *cpufunctbl[65536] ASM_SYM_FOR_FUNC ("cpufunctbl");
 #ifdef JIT
 extern void flush_icache(uaecptr, int);
 extern void flush_icache_hard(uaecptr, int);
+extern void flush_icache_cachestate(uaecptr, int);
 extern void compemu_reset(void);
 extern bool check_prefs_changed_comp (void);
 #else
 #define flush_icache(uaecptr, int) do {} while (0)
 #define flush_icache_hard(uaecptr, int) do {} while (0)
+#define flush_icache_cachestate(uaecptr, int) do {} while (0)
 #endif
 extern void flush_dcache (uaecptr, int);
 extern void flush_mmu (uaecptr, int);
@@ -369,6 +369,7 @@ struct uae_prefs {
 
 	bool comp_hardflush;
 	bool comp_constjump;
+	bool comp_keepblocks;
 	bool comp_oldsegv;
 
 	int cachesize;
@@ -445,6 +446,7 @@ struct uae_prefs {
 	bool rom_readwrite;
 	int turbo_emulation;
 	bool headless;
+	int benchmark_frames;
 	int filesys_limit;
 	int filesys_max_name;
 	int filesys_max_file_size;
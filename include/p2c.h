@@ -0,0 +1,181 @@
+ /*
+  * UAE - The Un*x Amiga Emulator
+  *
+  * Bitplane to chunky conversion kernels used by pfield_doline
+  *
+  * Copyright 1995-2000 Bernd Schmidt
+  */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_MSC_VER) && defined(_M_IX86))
+#define P2C_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#define MERGE(a,b,mask,shift) do {\
+	uae_u32 tmp = mask & (a ^ (b >> shift)); \
+	a ^= tmp; \
+	b ^= (tmp << shift); \
+} while (0)
+
+#define GETLONG(P) (*(uae_u32 *)P)
+
+STATIC_INLINE void pfield_doline_1 (uae_u32 *pixels, int wordcount, int planes, uae_u8 **bplpt)
+{
+	while (wordcount-- > 0) {
+		uae_u32 b0, b1, b2, b3, b4, b5, b6, b7;
+
+		b0 = 0, b1 = 0, b2 = 0, b3 = 0, b4 = 0, b5 = 0, b6 = 0, b7 = 0;
+		switch (planes) {
+#ifdef AGA
+		case 8: b0 = GETLONG (bplpt[7]); bplpt[7] += 4;
+		case 7: b1 = GETLONG (bplpt[6]); bplpt[6] += 4;
+#endif
+		case 6: b2 = GETLONG (bplpt[5]); bplpt[5] += 4;
+		case 5: b3 = GETLONG (bplpt[4]); bplpt[4] += 4;
+		case 4: b4 = GETLONG (bplpt[3]); bplpt[3] += 4;
+		case 3: b5 = GETLONG (bplpt[2]); bplpt[2] += 4;
+		case 2: b6 = GETLONG (bplpt[1]); bplpt[1] += 4;
+		case 1: b7 = GETLONG (bplpt[0]); bplpt[0] += 4;
+		}
+
+		MERGE (b0, b1, 0x55555555, 1);
+		MERGE (b2, b3, 0x55555555, 1);
+		MERGE (b4, b5, 0x55555555, 1);
+		MERGE (b6, b7, 0x55555555, 1);
+
+		MERGE (b0, b2, 0x33333333, 2);
+		MERGE (b1, b3, 0x33333333, 2);
+		MERGE (b4, b6, 0x33333333, 2);
+		MERGE (b5, b7, 0x33333333, 2);
+
+		MERGE (b0, b4, 0x0f0f0f0f, 4);
+		MERGE (b1, b5, 0x0f0f0f0f, 4);
+		MERGE (b2, b6, 0x0f0f0f0f, 4);
+		MERGE (b3, b7, 0x0f0f0f0f, 4);
+
+		MERGE (b0, b1, 0x00ff00ff, 8);
+		MERGE (b2, b3, 0x00ff00ff, 8);
+		MERGE (b4, b5, 0x00ff00ff, 8);
+		MERGE (b6, b7, 0x00ff00ff, 8);
+
+		MERGE (b0, b2, 0x0000ffff, 16);
+		do_put_mem_long (pixels, b0);
+		do_put_mem_long (pixels + 4, b2);
+		MERGE (b1, b3, 0x0000ffff, 16);
+		do_put_mem_long (pixels + 2, b1);
+		do_put_mem_long (pixels + 6, b3);
+		MERGE (b4, b6, 0x0000ffff, 16);
+		do_put_mem_long (pixels + 1, b4);
+		do_put_mem_long (pixels + 5, b6);
+		MERGE (b5, b7, 0x0000ffff, 16);
+		do_put_mem_long (pixels + 3, b5);
+		do_put_mem_long (pixels + 7, b7);
+		pixels += 8;
+	}
+}
+
+#ifdef P2C_SSE2
+
+/* Same merge network as pfield_doline_1, four words at a time, one
+word per 32-bit lane. Remaining words are done by the C version.  */
+
+#define MERGE_SSE2(a,b,mask,shift) do {\
+	__m128i tmp = _mm_and_si128 (mask, _mm_xor_si128 (a, _mm_srli_epi32 (b, shift))); \
+	a = _mm_xor_si128 (a, tmp); \
+	b = _mm_xor_si128 (b, _mm_slli_epi32 (tmp, shift)); \
+} while (0)
+
+#define GETLONG4(n) _mm_loadu_si128 ((__m128i*)bplpt[n]); bplpt[n] += 16
+
+STATIC_INLINE __m128i bswap32_sse2 (__m128i v)
+{
+	v = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1)), _MM_SHUFFLE (2, 3, 0, 1));
+	return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+}
+
+/* write longs a,b,c,d of four words to pixels[0-3], [8-11], [16-19], [24-27] */
+STATIC_INLINE void put_transposed_sse2 (uae_u32 *pixels, __m128i a, __m128i b, __m128i c, __m128i d)
+{
+	__m128i t0 = _mm_unpacklo_epi32 (a, b);
+	__m128i t1 = _mm_unpacklo_epi32 (c, d);
+	__m128i t2 = _mm_unpackhi_epi32 (a, b);
+	__m128i t3 = _mm_unpackhi_epi32 (c, d);
+	_mm_storeu_si128 ((__m128i*)(pixels + 0), bswap32_sse2 (_mm_unpacklo_epi64 (t0, t1)));
+	_mm_storeu_si128 ((__m128i*)(pixels + 8), bswap32_sse2 (_mm_unpackhi_epi64 (t0, t1)));
+	_mm_storeu_si128 ((__m128i*)(pixels + 16), bswap32_sse2 (_mm_unpacklo_epi64 (t2, t3)));
+	_mm_storeu_si128 ((__m128i*)(pixels + 24), bswap32_sse2 (_mm_unpackhi_epi64 (t2, t3)));
+}
+
+STATIC_INLINE void pfield_doline_sse2 (uae_u32 *pixels, int wordcount, int planes, uae_u8 **bplpt)
+{
+	const __m128i m1 = _mm_set1_epi32 (0x55555555);
+	const __m128i m2 = _mm_set1_epi32 (0x33333333);
+	const __m128i m4 = _mm_set1_epi32 (0x0f0f0f0f);
+	const __m128i m8 = _mm_set1_epi32 (0x00ff00ff);
+	const __m128i m16 = _mm_set1_epi32 (0x0000ffff);
+
+	while (wordcount >= 4) {
+		__m128i b0, b1, b2, b3, b4, b5, b6, b7;
+
+		b0 = b1 = b2 = b3 = b4 = b5 = b6 = b7 = _mm_setzero_si128 ();
+		switch (planes) {
+#ifdef AGA
+		case 8: b0 = GETLONG4 (7);
+		case 7: b1 = GETLONG4 (6);
+#endif
+		case 6: b2 = GETLONG4 (5);
+		case 5: b3 = GETLONG4 (4);
+		case 4: b4 = GETLONG4 (3);
+		case 3: b5 = GETLONG4 (2);
+		case 2: b6 = GETLONG4 (1);
+		case 1: b7 = GETLONG4 (0);
+		}
+
+		MERGE_SSE2 (b0, b1, m1, 1);
+		MERGE_SSE2 (b2, b3, m1, 1);
+		MERGE_SSE2 (b4, b5, m1, 1);
+		MERGE_SSE2 (b6, b7, m1, 1);
+
+		MERGE_SSE2 (b0, b2, m2, 2);
+		MERGE_SSE2 (b1, b3, m2, 2);
+		MERGE_SSE2 (b4, b6, m2, 2);
+		MERGE_SSE2 (b5, b7, m2, 2);
+
+		MERGE_SSE2 (b0, b4, m4, 4);
+		MERGE_SSE2 (b1, b5, m4, 4);
+		MERGE_SSE2 (b2, b6, m4, 4);
+		MERGE_SSE2 (b3, b7, m4, 4);
+
+		MERGE_SSE2 (b0, b1, m8, 8);
+		MERGE_SSE2 (b2, b3, m8, 8);
+		MERGE_SSE2 (b4, b5, m8, 8);
+		MERGE_SSE2 (b6, b7, m8, 8);
+
+		MERGE_SSE2 (b0, b2, m16, 16);
+		MERGE_SSE2 (b1, b3, m16, 16);
+		MERGE_SSE2 (b4, b6, m16, 16);
+		MERGE_SSE2 (b5, b7, m16, 16);
+
+		put_transposed_sse2 (pixels, b0, b4, b1, b5);
+		put_transposed_sse2 (pixels + 4, b2, b6, b3, b7);
+		pixels += 32;
+		wordcount -= 4;
+	}
+	pfield_doline_1 (pixels, wordcount, planes, bplpt);
+}
+
+static bool p2c_sse2_supported (void)
+{
+#if defined(_MSC_VER) && defined(_M_IX86)
+	int regs[4];
+	__cpuid (regs, 1);
+	return (regs[3] & (1 << 26)) != 0;
+#else
+	return true;
+#endif
+}
+
+#endif
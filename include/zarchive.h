@@ -2,6 +2,7 @@
 typedef uae_s64 (*ZFILEREAD)(void*, uae_u64, uae_u64, struct zfile*);
 typedef uae_s64 (*ZFILEWRITE)(const void*, uae_u64, uae_u64, struct zfile*);
 typedef uae_s64 (*ZFILESEEK)(struct zfile*, uae_s64, int);
+typedef void (*ZFILECLOSE)(struct zfile*);
 
 struct zfile {
     TCHAR *name;
@@ -27,8 +28,11 @@ struct zfile {
     ZFILEREAD zfileread;
     ZFILEWRITE zfilewrite;
     ZFILESEEK zfileseek;
+    ZFILECLOSE zfileclose; // frees userdata internals
     void *userdata;
     int useparent;
+    uae_u8 *mapped; // read-only view of physical file
+    uae_s64 mappedsize;
 };
 
 #define ZNODE_FILE 0
@@ -104,6 +108,8 @@ struct zarchive_info
 #define PEEK_BYTES 1024
 #define FILE_PEEK 1
 #define FILE_DELAYEDOPEN 2
+// larger archived files are decompressed on demand
+#define ZSTREAM_MIN (16 * 1024 * 1024)
 
 extern int zfile_is_ignore_ext (const TCHAR *name);
 
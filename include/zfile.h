@@ -63,6 +63,7 @@ extern int zfile_getc (struct zfile *z);
 extern int zfile_putc (int c, struct zfile *z);
 extern int zfile_ferror (struct zfile *z);
 extern uae_u8 *zfile_getdata (struct zfile *z, uae_s64 offset, int len);
+extern const uae_u8 *zfile_getdataptr (struct zfile *z, uae_s64 offset, uae_s64 len);
 extern void zfile_exit (void);
 extern int execute_command (TCHAR *);
 extern int zfile_iscompressed (struct zfile *z);
@@ -76,6 +77,8 @@ extern TCHAR *zfile_getfilename (struct zfile *f);
 extern uae_u32 zfile_crc32 (struct zfile *f);
 extern struct zfile *zfile_dup (struct zfile *f);
 extern struct zfile *zfile_gunzip (struct zfile *z);
+extern struct zfile *zfile_fopen_inflate (struct zfile *z, const TCHAR *name, uae_s64 offset, uae_s64 packedsize, uae_s64 size);
+extern struct zfile *zfile_fopen_stored (struct zfile *z, const TCHAR *name, uae_s64 offset, uae_s64 size);
 extern int zfile_is_diskimage (const TCHAR *name);
 extern int iszip (struct zfile *z);
 extern int zfile_convertimage (const TCHAR *src, const TCHAR *dst);
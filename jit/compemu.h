@@ -97,6 +97,7 @@ extern uae_u32 get_jitted_size(void);
 #ifdef JIT
 extern void flush_icache(uaecptr ptr, int n);
 extern void flush_icache_hard(uaecptr ptr, int n);
+extern void flush_icache_cachestate(uaecptr ptr, int n);
 #endif
 extern void alloc_cache(void);
 extern void compile_block(cpu_history* pc_hist, int blocklen, int totcyles);
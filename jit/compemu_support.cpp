@@ -43,6 +43,7 @@ int soft_flush_count=0;
 int hard_flush_count=0;
 int compile_count=0;
 int checksum_count=0;
+int reuse_count=0;
 static uae_u8* current_compile_p=NULL;
 static uae_u8* max_compile_start;
 uae_u8* compiled_code=NULL;
@@ -432,6 +433,7 @@ bool check_prefs_changed_comp (void)
 		currprefs.compnf != changed_prefs.compnf ||
 		currprefs.comp_hardflush != changed_prefs.comp_hardflush ||
 		currprefs.comp_constjump != changed_prefs.comp_constjump ||
+		currprefs.comp_keepblocks != changed_prefs.comp_keepblocks ||
 		currprefs.comp_oldsegv != changed_prefs.comp_oldsegv ||
 		currprefs.compfpu != changed_prefs.compfpu ||
 		currprefs.fpu_strict != changed_prefs.fpu_strict)
@@ -444,6 +446,7 @@ bool check_prefs_changed_comp (void)
 	currprefs.compnf = changed_prefs.compnf;
 	currprefs.comp_hardflush = changed_prefs.comp_hardflush;
 	currprefs.comp_constjump = changed_prefs.comp_constjump;
+	currprefs.comp_keepblocks = changed_prefs.comp_keepblocks;
 	currprefs.comp_oldsegv = changed_prefs.comp_oldsegv;
 	currprefs.compfpu = changed_prefs.compfpu;
 	currprefs.fpu_strict = changed_prefs.fpu_strict;
@@ -5328,7 +5331,7 @@ STATIC_INLINE unsigned int cft_map (unsigned int f)
 void set_cache_state(int enabled)
 {
 	if (enabled!=letit)
-		flush_icache_hard(0, 3);
+		flush_icache_cachestate(0, 3);
 	letit=enabled;
 }
 
@@ -5478,6 +5481,11 @@ static void check_checksum(void)
 	uae_u32     c1,c2;
 
 	checksum_count++;
+	if (!letit && currprefs.comp_keepblocks) {
+		/* Kept over a cache disable, leave it dormant until re-enabled */
+		execute_normal();
+		return;
+	}
 	/* These are not the droids you are looking for...  */
 	if (!bi) {
 		/* Whoever is the primary target is in a dormant state, but
@@ -5502,6 +5510,7 @@ static void check_checksum(void)
 		means we have to move it into the needs-to-be-flushed list */
 		bi->handler_to_use=bi->handler;
 		set_dhtu(bi,bi->direct_handler);
+		reuse_count++;
 
 		/*	write_log (_T("JIT: reactivate %p/%p (%x %x/%x %x)\n"),bi,bi->pc_p,
 		c1,c2,bi->c1,bi->c2);*/
@@ -5648,6 +5657,9 @@ static void prepare_block(blockinfo* bi)
 
 void compemu_reset(void)
 {
+	if (compile_count)
+		write_log (_T("JIT: %d blocks compiled, %d revalidated (%d checks), %d soft/%d hard flushes\n"),
+			compile_count, reuse_count, checksum_count, soft_flush_count, hard_flush_count);
 	set_cache_state(0);
 }
 
@@ -5825,6 +5837,17 @@ void flush_icache_hard(uaecptr ptr, int n)
 we simply mark everything as "needs to be checked".
 */
 
+/* CPU cache enable/disable. With comp_keepblocks the translations are
+only soft flushed and get revalidated by checksum when the cache comes
+back on. */
+void flush_icache_cachestate(uaecptr ptr, int n)
+{
+	if (currprefs.comp_keepblocks)
+		flush_icache(ptr, n);
+	else
+		flush_icache_hard(ptr, n);
+}
+
 void flush_icache(uaecptr ptr, int n)
 {
 	blockinfo* bi;
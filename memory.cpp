@@ -20,6 +20,8 @@
 #include "custom.h"
 #include "events.h"
 #include "newcpu.h"
+#include "cpummu.h"
+#include "cpummu030.h"
 #include "autoconf.h"
 #include "savestate.h"
 #include "ar.h"
@@ -1110,7 +1112,7 @@ addrbank chipmem_bank = {
 	chipmem_lget, chipmem_wget, chipmem_bget,
 	chipmem_lput, chipmem_wput, chipmem_bput,
 	chipmem_xlate, chipmem_check, NULL, _T("chip"), _T("Chip memory"),
-	chipmem_lget, chipmem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	chipmem_lget, chipmem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 addrbank chipmem_dummy_bank = {
@@ -1134,7 +1136,7 @@ addrbank bogomem_bank = {
 	bogomem_lget, bogomem_wget, bogomem_bget,
 	bogomem_lput, bogomem_wput, bogomem_bput,
 	bogomem_xlate, bogomem_check, NULL, _T("bogo"), _T("Slow memory"),
-	bogomem_lget, bogomem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	bogomem_lget, bogomem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 addrbank cardmem_bank = {
@@ -1148,28 +1150,28 @@ addrbank mem25bit_bank = {
 	mem25bit_lget, mem25bit_wget, mem25bit_bget,
 	mem25bit_lput, mem25bit_wput, mem25bit_bput,
 	mem25bit_xlate, mem25bit_check, NULL, _T("25bitmem"), _T("25bit memory"),
-	mem25bit_lget, mem25bit_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	mem25bit_lget, mem25bit_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 addrbank a3000lmem_bank = {
 	a3000lmem_lget, a3000lmem_wget, a3000lmem_bget,
 	a3000lmem_lput, a3000lmem_wput, a3000lmem_bput,
 	a3000lmem_xlate, a3000lmem_check, NULL, _T("ramsey_low"), _T("RAMSEY memory (low)"),
-	a3000lmem_lget, a3000lmem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	a3000lmem_lget, a3000lmem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 addrbank a3000hmem_bank = {
 	a3000hmem_lget, a3000hmem_wget, a3000hmem_bget,
 	a3000hmem_lput, a3000hmem_wput, a3000hmem_bput,
 	a3000hmem_xlate, a3000hmem_check, NULL, _T("ramsey_high"), _T("RAMSEY memory (high)"),
-	a3000hmem_lget, a3000hmem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	a3000hmem_lget, a3000hmem_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 addrbank kickmem_bank = {
 	kickmem_lget, kickmem_wget, kickmem_bget,
 	kickmem_lput, kickmem_wput, kickmem_bput,
 	kickmem_xlate, kickmem_check, NULL, _T("kick"), _T("Kickstart ROM"),
-	kickmem_lget, kickmem_wget, ABFLAG_ROM | ABFLAG_THREADSAFE
+	kickmem_lget, kickmem_wget, ABFLAG_ROM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 addrbank kickram_bank = {
@@ -1183,13 +1185,13 @@ addrbank extendedkickmem_bank = {
 	extendedkickmem_lget, extendedkickmem_wget, extendedkickmem_bget,
 	extendedkickmem_lput, extendedkickmem_wput, extendedkickmem_bput,
 	extendedkickmem_xlate, extendedkickmem_check, NULL, NULL, _T("Extended Kickstart ROM"),
-	extendedkickmem_lget, extendedkickmem_wget, ABFLAG_ROM | ABFLAG_THREADSAFE
+	extendedkickmem_lget, extendedkickmem_wget, ABFLAG_ROM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 addrbank extendedkickmem2_bank = {
 	extendedkickmem2_lget, extendedkickmem2_wget, extendedkickmem2_bget,
 	extendedkickmem2_lput, extendedkickmem2_wput, extendedkickmem2_bput,
 	extendedkickmem2_xlate, extendedkickmem2_check, NULL, _T("rom_a8"), _T("Extended 2nd Kickstart ROM"),
-	extendedkickmem2_lget, extendedkickmem2_wget, ABFLAG_ROM | ABFLAG_THREADSAFE
+	extendedkickmem2_lget, extendedkickmem2_wget, ABFLAG_ROM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 MEMORY_FUNCTIONS(custmem1);
@@ -1199,13 +1201,13 @@ addrbank custmem1_bank = {
 	custmem1_lget, custmem1_wget, custmem1_bget,
 	custmem1_lput, custmem1_wput, custmem1_bput,
 	custmem1_xlate, custmem1_check, NULL, _T("custmem1"), _T("Non-autoconfig RAM #1"),
-	custmem1_lget, custmem1_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	custmem1_lget, custmem1_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 addrbank custmem2_bank = {
 	custmem2_lget, custmem2_wget, custmem2_bget,
 	custmem2_lput, custmem2_wput, custmem2_bput,
 	custmem2_xlate, custmem2_check, NULL, _T("custmem2"), _T("Non-autoconfig RAM #2"),
-	custmem2_lget, custmem2_wget, ABFLAG_RAM | ABFLAG_THREADSAFE
+	custmem2_lget, custmem2_wget, ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS
 };
 
 #define fkickmem_size ROM_SIZE_512
@@ -2665,6 +2667,26 @@ void map_banks_cond (addrbank *bank, int start, int size, int realsize)
 	map_banks (bank, start, size, realsize);
 }
 
+/* Enforcer and Action Replay swap chip RAM handlers without map_banks().
+ * Host pointers must not bypass them, so the bank is only direct access
+ * while the stock handlers are installed. */
+void chipmem_handlers_changed (void)
+{
+	if (chipmem_bank.lget == chipmem_lget && chipmem_bank.wget == chipmem_wget && chipmem_bank.bget == chipmem_bget
+		&& chipmem_bank.lput == chipmem_lput && chipmem_bank.wput == chipmem_wput && chipmem_bank.bput == chipmem_bput
+		&& chipmem_bank.check == chipmem_check)
+		chipmem_bank.flags |= ABFLAG_DIRECTACCESS;
+	else
+		chipmem_bank.flags &= ~ABFLAG_DIRECTACCESS;
+	if (currprefs.mmu_model == 68030)
+		mmu030_flush_atc_hash ();
+	else if (currprefs.mmu_model >= 68040)
+		mmu_flush_fast ();
+#ifdef WITH_PPC
+	uae_ppc_memory_changed ();
+#endif
+}
+
 static void map_banks2 (addrbank *bank, int start, int size, int realsize, int quick)
 {
 	int bnr, old;
@@ -2674,6 +2696,13 @@ static void map_banks2 (addrbank *bank, int start, int size, int realsize, int q
 	if (quick <= 0)
 		old = debug_bankchange (-1);
 	flush_icache_hard (0, 3); /* Sure don't want to keep any old mappings around! */
+	if (currprefs.mmu_model == 68030)
+		mmu030_flush_atc_hash ();
+	else if (currprefs.mmu_model >= 68040)
+		mmu_flush_fast ();
+#ifdef WITH_PPC
+	uae_ppc_memory_changed ();
+#endif
 #ifdef NATMEM_OFFSET
 	if (!quick)
 		delete_shmmaps (start << 16, size << 16);
@@ -3813,8 +3813,6 @@ static void m68k_run_1 (void)
 					}
 				}
 				regs.ipl = regs.ipl_pin;
-				if (!currprefs.cpu_compatible || (currprefs.cpu_cycle_exact && currprefs.cpu_model <= 68000))
-					return;
 			}
 		} CATCH (prb) {
 			bus_error();
@@ -3920,9 +3918,6 @@ cont:
 					if (do_specialties (0))
 						return;
 				}
-
-				if (!currprefs.cpu_cycle_exact || currprefs.cpu_model > 68000)
-					return;
 			}
 		} CATCH (prb) {
 			bus_error();
@@ -4777,6 +4772,10 @@ void m68k_go (int may_quit)
 			}
 		}
 
+		/* CPU prefs only change above, on SPCFLAG_MODE_CHANGE, which makes
+		 * do_specialties() leave the run loop. The run loops therefore keep
+		 * their TRY block set up across instructions and only come back here
+		 * for mode changes, resets and halts. */
 #if 0
 		if (mmu_enabled && !currprefs.cachesize) {
 			run_func = m68k_run_mmu;
@@ -3,6 +3,11 @@
 #pragma warning (disable : 4996)
 #pragma warning (disable : 4018)
 
+/* project files only define WIN64 for x64, ARM64 gets it from the compiler */
+#if defined(_WIN64) && !defined(WIN64)
+#define WIN64
+#endif
+
 #define DIRECTINPUT_VERSION  0x0800
 #define DIRECT3D_VERSION 0x0900
 #define SUPPORT_THREADS
@@ -143,11 +148,24 @@
 
 #include <stdint.h>
 
+#if defined(_M_ARM64) || defined(__aarch64__)
+/* no x86 code on ARM64 hosts, JIT has no AArch64 backend */
+#undef X86_MSVC_ASSEMBLY_MEMACCESS
+#undef X86_MSVC_ASSEMBLY
+#undef OPTIMIZED_FLAGS
+#undef __i386__
+#undef JIT
+#undef USE_X86_FPUCW
+#define USE_X86_FPUCW 0
+#endif
+
 #ifdef WIN64
 #undef X86_MSVC_ASSEMBLY_MEMACCESS
 #undef X86_MSVC_ASSEMBLY
 #undef JIT
+#if !defined(_M_ARM64)
 #define X64_MSVC_ASSEMBLY
+#endif
 #define CPU_64_BIT
 #define SIZEOF_VOID_P 8
 #else
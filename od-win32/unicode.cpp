@@ -323,6 +323,29 @@ int same_aname (const TCHAR *an1, const TCHAR *an2)
 	return CompareString (LOCALE_INVARIANT, NORM_IGNORECASE, an1, -1, an2, -1) == CSTR_EQUAL;
 }
 
+/* FNV-1a over the sort key CompareString() compares, names that are
+ * equal for same_aname() always hash the same. */
+uae_u32 aname_hash (uae_u32 h, const TCHAR *an)
+{
+	BYTE key[1024];
+	BYTE *kp = key;
+	int len;
+
+	len = LCMapString (LOCALE_INVARIANT, LCMAP_SORTKEY | NORM_IGNORECASE, an, -1, (LPWSTR)key, sizeof key);
+	if (!len) {
+		len = LCMapString (LOCALE_INVARIANT, LCMAP_SORTKEY | NORM_IGNORECASE, an, -1, NULL, 0);
+		if (len <= 0)
+			return h;
+		kp = xmalloc (BYTE, len);
+		len = LCMapString (LOCALE_INVARIANT, LCMAP_SORTKEY | NORM_IGNORECASE, an, -1, (LPWSTR)kp, len);
+	}
+	for (int i = 0; i < len; i++)
+		h = (h ^ kp[i]) * 16777619;
+	if (kp != key)
+		xfree (kp);
+	return h;
+}
+
 void to_lower (TCHAR *s, int len)
 {
 	CharLowerBuff (s, len);
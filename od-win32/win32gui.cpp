@@ -1374,37 +1374,31 @@ static int msi_cpuboard[] = { 0, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
 struct romscandata {
 	UAEREG *fkey;
 	int got;
+	struct romscancache *rc;
 };
 
-static struct romdata *scan_single_rom_2 (struct zfile *f)
+static struct romdata *scan_single_rom_3 (const uae_u8 *data, int datasize, const TCHAR *name)
 {
-	uae_u8 buffer[20] = { 0 };
 	uae_u8 *rombuf;
-	int cl = 0, size;
+	int cl = 0, size = datasize, offset = 0;
 	struct romdata *rd = 0;
 
-	zfile_fseek (f, 0, SEEK_END);
-	size = zfile_ftell (f);
-	zfile_fseek (f, 0, SEEK_SET);
-	if (size > 524288 * 2)  {/* don't skip KICK disks or 1M ROMs */
-		write_log (_T("'%s': too big %d, ignored\n"), zfile_getname(f), size);
-		return 0;
-	}
-	zfile_fread (buffer, 1, 11, f);
-	if (!memcmp (buffer, "KICK", 4)) {
-		zfile_fseek (f, 512, SEEK_SET);
+	if (datasize >= 4 && !memcmp (data, "KICK", 4)) {
+		offset = 512;
 		if (size > 262144)
 			size = 262144;
-	} else if (!memcmp (buffer, "AMIROMTYPE1", 11)) {
+	} else if (datasize >= 11 && !memcmp (data, "AMIROMTYPE1", 11)) {
 		cl = 1;
+		offset = 11;
 		size -= 11;
-	} else {
-		zfile_fseek (f, 0, SEEK_SET);
 	}
+	if (size <= 0)
+		return 0;
 	rombuf = xcalloc (uae_u8, size);
 	if (!rombuf)
 		return 0;
-	zfile_fread (rombuf, 1, size, f);
+	if (datasize > offset)
+		memcpy (rombuf, data + offset, datasize - offset < size ? datasize - offset : size);
 	if (cl > 0) {
 		decode_cloanto_rom_do (rombuf, size, size);
 		cl = 0;
@@ -1423,22 +1417,80 @@ static struct romdata *scan_single_rom_2 (struct zfile *f)
 		}
 	}
 	if (!rd) {
-		const TCHAR *name = my_getfilepart(zfile_getname(f));
-		rd = getfrombydefaultname(name, size);
-	}
+		rd = getfrombydefaultname(my_getfilepart(name), size);
+	}
+	// not get_sha1_txt(), its static buffer is shared by the scan threads
+	uae_u8 sha1[SHA1_SIZE];
+	TCHAR sha1txt[SHA1_SIZE * 2 + 1];
+	get_sha1 (rombuf, size, sha1);
+	for (int i = 0; i < SHA1_SIZE; i++)
+		_stprintf (sha1txt + i * 2, _T("%02X"), sha1[i]);
 	if (!rd) {
 		write_log (_T("!: Name='%s':%d\nCRC32=%08X SHA1=%s\n"),
-			zfile_getname (f), size, get_crc32 (rombuf, size), get_sha1_txt (rombuf, size));
+			name, size, get_crc32 (rombuf, size), sha1txt);
 	} else {
 		TCHAR tmp[MAX_DPATH];
 		getromname (rd, tmp);
 		write_log (_T("*: %s:%d = %s\nCRC32=%08X SHA1=%s\n"),
-			zfile_getname (f), size, tmp, get_crc32 (rombuf, size), get_sha1_txt (rombuf, size));
+			name, size, tmp, get_crc32 (rombuf, size), sha1txt);
 	}
 	xfree (rombuf);
 	return rd;
 }
 
+static struct romdata *scan_single_rom_2 (struct zfile *f)
+{
+	uae_u8 *data;
+	int size;
+	struct romdata *rd;
+
+	zfile_fseek (f, 0, SEEK_END);
+	size = zfile_ftell (f);
+	zfile_fseek (f, 0, SEEK_SET);
+	if (size > 524288 * 2)  {/* don't skip KICK disks or 1M ROMs */
+		write_log (_T("'%s': too big %d, ignored\n"), zfile_getname(f), size);
+		return 0;
+	}
+	data = xcalloc (uae_u8, size + 1);
+	if (!data)
+		return 0;
+	size = zfile_fread (data, 1, size, f);
+	rd = scan_single_rom_3 (data, size, zfile_getname (f));
+	xfree (data);
+	return rd;
+}
+
+/* plain files only, no zfile: safe to call from the ROM scan threads */
+static struct romdata *scan_single_rom_file (const TCHAR *path)
+{
+	uae_u8 *data;
+	int size;
+	struct romdata *rd;
+	FILE *f;
+
+	f = _tfopen (path, _T("rb"));
+	if (!f)
+		return 0;
+	_fseeki64 (f, 0, SEEK_END);
+	size = (int)_ftelli64 (f);
+	_fseeki64 (f, 0, SEEK_SET);
+	if (size > 524288 * 2)  {
+		write_log (_T("'%s': too big %d, ignored\n"), path, size);
+		fclose (f);
+		return 0;
+	}
+	data = xcalloc (uae_u8, size + 1);
+	if (!data) {
+		fclose (f);
+		return 0;
+	}
+	size = fread (data, 1, size, f);
+	fclose (f);
+	rd = scan_single_rom_3 (data, size, path);
+	xfree (data);
+	return rd;
+}
+
 static struct romdata *scan_single_rom (const TCHAR *path)
 {
 	struct zfile *z;
@@ -1589,6 +1641,190 @@ static bool scan_rom_hook (const TCHAR *name, int line)
 	return infoboxdialogstate;
 }
 
+/* Results of earlier ROM scans, one line per file: size, mtime, keyring
+ * size and the ROMs found in it. Unchanged files are not read again. */
+#define ROMSCAN_CACHE_NAME _T("romscan.cache")
+#define ROMSCAN_CACHE_HASH 4096
+#define ROMSCAN_CACHE_HITS 8
+#define ROMSCAN_THREADS 8
+
+struct romscanhit
+{
+	int id, group;
+	TCHAR *name;
+};
+
+struct romscancache
+{
+	struct romscancache *next;
+	TCHAR *path;
+	uae_u64 size, mtime;
+	int keys;
+	int numhits;
+	struct romscanhit hits[ROMSCAN_CACHE_HITS];
+	bool valid, used, nocache;
+};
+
+static struct romscancache *romscan_cache[ROMSCAN_CACHE_HASH];
+
+static unsigned int romscan_cache_hash (const TCHAR *path)
+{
+	unsigned int h = 2166136261u;
+	while (*path)
+		h = (h ^ _totupper (*path++)) * 16777619;
+	return h & (ROMSCAN_CACHE_HASH - 1);
+}
+
+static struct romscancache *romscan_cache_get (const TCHAR *path)
+{
+	unsigned int h = romscan_cache_hash (path);
+	struct romscancache *rc;
+
+	for (rc = romscan_cache[h]; rc; rc = rc->next) {
+		if (!_tcsicmp (rc->path, path))
+			return rc;
+	}
+	rc = xcalloc (struct romscancache, 1);
+	if (!rc)
+		return NULL;
+	rc->path = my_strdup (path);
+	rc->next = romscan_cache[h];
+	romscan_cache[h] = rc;
+	return rc;
+}
+
+static void romscan_cache_reset (struct romscancache *rc)
+{
+	for (int i = 0; i < rc->numhits; i++)
+		xfree (rc->hits[i].name);
+	rc->numhits = 0;
+	rc->nocache = false;
+}
+
+static void romscan_cache_addhit (struct romscancache *rc, const struct romdata *rd, const TCHAR *name)
+{
+	struct romscanhit *h;
+
+	if (!rc)
+		return;
+	if (rc->numhits >= ROMSCAN_CACHE_HITS) {
+		rc->nocache = true;
+		return;
+	}
+	h = &rc->hits[rc->numhits++];
+	h->id = rd->id;
+	h->group = rd->group;
+	h->name = my_strdup (name);
+}
+
+static void romscan_cache_free (void)
+{
+	for (int i = 0; i < ROMSCAN_CACHE_HASH; i++) {
+		struct romscancache *rc = romscan_cache[i];
+		while (rc) {
+			struct romscancache *next = rc->next;
+			romscan_cache_reset (rc);
+			xfree (rc->path);
+			xfree (rc);
+			rc = next;
+		}
+		romscan_cache[i] = NULL;
+	}
+}
+
+static void romscan_cache_load (void)
+{
+	TCHAR path[MAX_DPATH];
+	TCHAR *line;
+	FILE *f;
+	int linesize = MAX_DPATH * (ROMSCAN_CACHE_HITS + 2);
+
+	_stprintf (path, _T("%s%s"), start_path_data, ROMSCAN_CACHE_NAME);
+	f = _tfopen (path, _T("rt, ccs=UTF-8"));
+	if (!f)
+		return;
+	line = xmalloc (TCHAR, linesize);
+	// ROM table changed: everything has to be identified again
+	if (!line || !_fgetts (line, linesize, f) || _tcsncmp (line, _T("ROMSCAN1 "), 9) || _tcstoul (line + 9, NULL, 16) != getromdatasignature ()) {
+		xfree (line);
+		fclose (f);
+		return;
+	}
+	while (_fgetts (line, linesize, f)) {
+		TCHAR *fields[3 + 1 + ROMSCAN_CACHE_HITS * 3];
+		TCHAR *p = line;
+		int num = 0;
+		struct romscancache *rc;
+
+		p[_tcscspn (p, _T("\r\n"))] = 0;
+		while (num < (int)(sizeof fields / sizeof (TCHAR*))) {
+			fields[num++] = p;
+			p = _tcschr (p, '|');
+			if (!p)
+				break;
+			*p++ = 0;
+		}
+		if (num < 4 || ((num - 4) % 3))
+			continue;
+		rc = romscan_cache_get (fields[3]);
+		if (!rc)
+			break;
+		romscan_cache_reset (rc);
+		rc->size = _tcstoui64 (fields[0], NULL, 10);
+		rc->mtime = _tcstoui64 (fields[1], NULL, 10);
+		rc->keys = _tstol (fields[2]);
+		for (int i = 4; i < num; i += 3) {
+			struct romscanhit *h = &rc->hits[rc->numhits++];
+			h->id = _tstol (fields[i + 0]);
+			h->group = _tstol (fields[i + 1]);
+			h->name = my_strdup (fields[i + 2]);
+		}
+		rc->valid = true;
+	}
+	xfree (line);
+	fclose (f);
+}
+
+/* entries of files that were not seen in this scan (other path, cancelled
+ * scan) are kept as long as the file still exists */
+static void romscan_cache_save (void)
+{
+	TCHAR path[MAX_DPATH];
+	FILE *f;
+
+	_stprintf (path, _T("%s%s"), start_path_data, ROMSCAN_CACHE_NAME);
+	f = _tfopen (path, _T("wt, ccs=UTF-8"));
+	if (!f)
+		return;
+	_ftprintf (f, _T("ROMSCAN1 %08X\n"), getromdatasignature ());
+	for (int i = 0; i < ROMSCAN_CACHE_HASH; i++) {
+		for (struct romscancache *rc = romscan_cache[i]; rc; rc = rc->next) {
+			if (!rc->valid || rc->nocache)
+				continue;
+			if (!rc->used && !my_existsfile (rc->path))
+				continue;
+			_ftprintf (f, _T("%llu|%llu|%d|%s"), rc->size, rc->mtime, rc->keys, rc->path);
+			for (int j = 0; j < rc->numhits; j++)
+				_ftprintf (f, _T("|%d|%d|%s"), rc->hits[j].id, rc->hits[j].group, rc->hits[j].name);
+			_ftprintf (f, _T("\n"));
+		}
+	}
+	fclose (f);
+}
+
+static void scan_rom_found (struct romscandata *rsd, struct romdata *rd, const TCHAR *path)
+{
+	TCHAR name[MAX_DPATH];
+
+	getromname (rd, name);
+	scan_rom_hook (name, 3);
+	addrom (rsd->fkey, rd, path);
+	if (rd->type & ROMTYPE_KEY)
+		addkeyfile (path);
+	rsd->got = 1;
+	romscan_cache_addhit (rsd->rc, rd, path);
+}
+
 static int scan_rom_2 (struct zfile *f, void *vrsd)
 {
 	struct romscandata *rsd = (struct romscandata*)vrsd;
@@ -1601,33 +1837,77 @@ static int scan_rom_2 (struct zfile *f, void *vrsd)
 		return 0;
 	rd = scan_single_rom_2 (f);
 	if (rd) {
-		TCHAR name[MAX_DPATH];
-		getromname (rd, name);
-		scan_rom_hook (name, 3);
-		addrom (rsd->fkey, rd, path);
-		if (rd->type & ROMTYPE_KEY)
-			addkeyfile (path);
-		rsd->got = 1;
+		scan_rom_found (rsd, rd, path);
 	} else if (_tcslen (path) > _tcslen (romkey) && !_tcsicmp (path + _tcslen (path) - _tcslen (romkey), romkey)) {
 		addkeyfile (path);
+		// keys must be reloaded every time
+		if (rsd->rc)
+			rsd->rc->nocache = true;
 	}
 	return 0;
 }
 
-static int scan_rom (const TCHAR *path, UAEREG *fkey, bool deepscan)
+struct romscanfile
 {
-	struct romscandata rsd = { fkey, 0 };
+	TCHAR *path;
+	struct romscancache *rc;
+	bool cached; // rc has the result
+	bool plain; // identified by the scan threads
 	struct romdata *rd;
-	int cnt = 0;
+};
 
-	if (!isromext (path, deepscan)) {
-		//write_log("ROMSCAN: skipping file '%s', unknown extension\n", path);
-		return 0;
+struct romscanjob
+{
+	struct romscanfile *files;
+	int num;
+	volatile LONG next, running;
+	volatile bool abort;
+};
+
+/* ROM images that are usually not archives, these are read and hashed in
+ * parallel. Anything the threads can't identify (compressed ROMs) goes
+ * through zfile afterwards. */
+static bool isromplain (const TCHAR *path)
+{
+	const TCHAR *ext = _tcsrchr (path, '.');
+
+	if (!ext)
+		return false;
+	ext++;
+	if (!_tcsicmp (ext, _T("rom")) || !_tcsicmp (ext, _T("bin"))
+		|| !_tcsicmp (ext, _T("a500")) || !_tcsicmp (ext, _T("a1200")) || !_tcsicmp (ext, _T("a4000")) || !_tcsicmp (ext, _T("cd32")))
+		return true;
+	if (_tcslen (ext) >= 2 && toupper(ext[0]) == 'U' && isdigit (ext[1]))
+		return true;
+	return false;
+}
+
+static void *romscan_thread (void *v)
+{
+	struct romscanjob *job = (struct romscanjob*)v;
+
+	for (;;) {
+		LONG i = InterlockedIncrement (&job->next) - 1;
+		if (i >= job->num || job->abort)
+			break;
+		struct romscanfile *sf = &job->files[i];
+		if (sf->plain && !sf->cached)
+			sf->rd = scan_single_rom_file (sf->path);
 	}
-	scan_rom_hook (path, 2);
+	InterlockedDecrement (&job->running);
+	return NULL;
+}
+
+static int scan_rom (struct romscanfile *sf, UAEREG *fkey)
+{
+	struct romscandata rsd = { fkey, 0, NULL };
+	struct romdata *rd;
+	int cnt = 0;
+
+	scan_rom_hook (sf->path, 2);
 	for (;;) {
 		TCHAR tmp[MAX_DPATH];
-		_tcscpy (tmp, path);
+		_tcscpy (tmp, sf->path);
 		rd = scan_arcadia_rom (tmp, cnt++);
 		if (rd) {
 			if (!addrom (fkey, rd, tmp))
@@ -1636,7 +1916,22 @@ static int scan_rom (const TCHAR *path, UAEREG *fkey, bool deepscan)
 		}
 		break;
 	}
-	zfile_zopen (path, scan_rom_2, (void*)&rsd);
+	if (sf->cached) {
+		for (int i = 0; i < sf->rc->numhits; i++) {
+			struct romscanhit *h = &sf->rc->hits[i];
+			rd = getromdatabyidgroup (h->id, h->group >> 16, h->group & 65535);
+			if (rd)
+				scan_rom_found (&rsd, rd, h->name);
+		}
+		return rsd.got;
+	}
+	rsd.rc = sf->rc;
+	if (sf->plain && sf->rd) {
+		scan_rom_found (&rsd, sf->rd, sf->path);
+	} else {
+		// zfile detects compressed containers by content, not extension
+		zfile_zopen (sf->path, scan_rom_2, (void*)&rsd);
+	}
 	return rsd.got;
 }
 
@@ -1794,7 +2089,8 @@ static int scan_roms_2 (UAEREG *fkey, const TCHAR *path, bool deepscan)
 	TCHAR buf[MAX_DPATH];
 	WIN32_FIND_DATA find_data;
 	HANDLE handle;
-	int ret;
+	struct romscanjob job = { 0 };
+	int ret, i, max, keys, work, threads;
 
 	if (!path)
 		return 0;
@@ -1806,19 +2102,85 @@ static int scan_roms_2 (UAEREG *fkey, const TCHAR *path, bool deepscan)
 	if (handle == INVALID_HANDLE_VALUE)
 		return 0;
 	scan_rom_hook (path, 1);
+	keys = get_keyring ();
+	max = 0;
+	work = 0;
 	for (;;) {
 		TCHAR tmppath[MAX_DPATH];
 		_tcscpy (tmppath, path);
 		_tcscat (tmppath, find_data.cFileName);
-		if (!(find_data.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY |FILE_ATTRIBUTE_SYSTEM)) && find_data.nFileSizeLow < 10000000) {
-			if (scan_rom (tmppath, fkey, deepscan))
-				ret = 1;
+		if (!(find_data.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY |FILE_ATTRIBUTE_SYSTEM)) && find_data.nFileSizeLow < 10000000 && isromext (tmppath, deepscan)) {
+			struct romscanfile *sf;
+			uae_u64 size = ((uae_u64)find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow;
+			uae_u64 mtime = ((uae_u64)find_data.ftLastWriteTime.dwHighDateTime << 32) | find_data.ftLastWriteTime.dwLowDateTime;
+			if (job.num == max) {
+				max += 256;
+				job.files = xrealloc (struct romscanfile, job.files, max);
+			}
+			sf = &job.files[job.num++];
+			memset (sf, 0, sizeof (struct romscanfile));
+			sf->path = my_strdup (tmppath);
+			sf->rc = romscan_cache_get (tmppath);
+			if (sf->rc) {
+				struct romscancache *rc = sf->rc;
+				sf->cached = rc->valid && rc->size == size && rc->mtime == mtime && rc->keys == keys;
+				if (!sf->cached) {
+					romscan_cache_reset (rc);
+					rc->size = size;
+					rc->mtime = mtime;
+					rc->keys = keys;
+					rc->valid = true;
+				}
+				rc->used = true;
+			}
+			sf->plain = isromplain (tmppath);
+			if (sf->plain && !sf->cached)
+				work++;
 		}
 		if (!scan_rom_hook (NULL, 0) || FindNextFile (handle, &find_data) == 0) {
 			FindClose (handle);
 			break;
 		}
 	}
+
+	// identify plain ROM files in parallel, archives need zfile and stay on this thread
+	threads = cpu_number < ROMSCAN_THREADS ? cpu_number : ROMSCAN_THREADS;
+	if (threads > work)
+		threads = work;
+	if (threads > 1) {
+		write_log (_T("ROM scan: %d/%d files, %d threads\n"), work, job.num, threads);
+		job.running = threads;
+		for (i = 0; i < threads; i++) {
+			// normal priority, GUI must stay responsive
+			if (!uae_start_thread (NULL, romscan_thread, &job, NULL))
+				InterlockedDecrement (&job.running);
+		}
+		while (job.running > 0) {
+			if (!scan_rom_hook (NULL, 0))
+				job.abort = true;
+			Sleep (10);
+		}
+	}
+	// anything the threads did not get to is done here
+	if (!job.abort) {
+		job.running = 1;
+		romscan_thread (&job);
+	}
+
+	for (i = 0; i < job.num; i++) {
+		struct romscanfile *sf = &job.files[i];
+		if (!job.abort && scan_rom_hook (NULL, 0)) {
+			if (scan_rom (sf, fkey))
+				ret = 1;
+		} else {
+			job.abort = true;
+			// not identified, must not be cached as empty
+			if (sf->rc && !sf->cached)
+				sf->rc->nocache = true;
+		}
+		xfree (sf->path);
+	}
+	xfree (job.files);
 	return ret;
 }
 
@@ -1871,6 +2233,7 @@ int scan_roms (HWND hDlg, int show)
 	fkey = regcreatetree (NULL, _T("DetectedROMs"));
 	if (fkey == NULL)
 		goto end;
+	romscan_cache_load ();
 
 	infoboxdialogstate = true;
 	infoboxhwnd = NULL;
@@ -1914,6 +2277,7 @@ int scan_roms (HWND hDlg, int show)
 
 	for (i = 0; i < MAX_ROM_PATHS; i++)
 		xfree (paths[i]);
+	romscan_cache_save ();
 
 	fkey2 = regcreatetree (NULL, _T("DetectedROMS"));
 	if (fkey2) {
@@ -1939,6 +2303,7 @@ end:
 			DispatchMessage (&msg);
 		}
 	}
+	romscan_cache_free ();
 	read_rom_list ();
 	if (show)
 		show_rom_list ();
@@ -0,0 +1,16 @@
+#!/bin/sh
+# Builds p2c_test.cpp with and without AGA (8 or 6 planes) and checks the
+# SSE2 bitplane to chunky kernels against the scalar ones.
+# Usage: p2c_test.sh [iterations]
+
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=${TMPDIR:-/tmp}/p2c_test.$$
+
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+$CXX -O2 -DAGA -I"$DIR/include" -o "$TMP/aga" "$DIR/p2c_test.cpp" || exit 1
+$CXX -O2 -I"$DIR/include" -o "$TMP/ecs" "$DIR/p2c_test.cpp" || exit 1
+"$TMP/aga" "$@" || exit 1
+"$TMP/ecs" "$@" || exit 1
@@ -21,6 +21,7 @@
 
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 
 #include "system/systhread.h"
 #include "system/arch/sysendian.h"
@@ -107,17 +108,98 @@ void PPCCALL ppc_cpu_do_dec(int val)
 static uint ops = 0;
 static int ppc_trace;
 
+/*
+ *	Predecode cache
+ *
+ *	Decoded handlers are kept per physical code page so that the fetch
+ *	loop only byte swaps and walks the opcode tables the first time an
+ *	instruction is executed. Each slot remembers the raw word it was
+ *	decoded from. Code can be changed behind our back by the 68k side or
+ *	by DMA, so a slot whose word no longer matches memory is decoded again.
+ */
+
+#define PPC_DEC_PAGES		64
+#define PPC_DEC_SLOTS		(4096 / 4)
+// instructions run before pending exceptions and the decrementer are looked at
+#define PPC_DEC_MAXBLOCK	64
+
+struct ppc_dec_slot {
+	ppc_opc_function func;
+	uint32 raw;
+	uint32 opc;
+	bool sync;
+};
+
+struct ppc_dec_page {
+	byte *page;
+	ppc_dec_slot slot[PPC_DEC_SLOTS];
+};
+
+static ppc_dec_page *ppc_dec_pages[PPC_DEC_PAGES];
+static ppc_dec_page *ppc_dec_current;
+
+// mfspr, mftb and mtspr see the time base and decrementer, run them with
+// the block counts flushed
+static bool ppc_dec_is_sync(uint32 opc)
+{
+	if (PPC_OPC_MAIN(opc) != 31)
+		return false;
+	switch (PPC_OPC_EXT(opc)) {
+	case 339:
+	case 371:
+	case 467:
+		return true;
+	}
+	return false;
+}
+
+static ppc_dec_page *ppc_dec_get_page(byte *page)
+{
+	uint idx = ((size_t)page >> 12) & (PPC_DEC_PAGES - 1);
+	ppc_dec_page *dp = ppc_dec_pages[idx];
+	if (dp && dp->page == page)
+		return dp;
+	if (!dp) {
+		dp = (ppc_dec_page*)malloc(sizeof(ppc_dec_page));
+		if (!dp)
+			return NULL;
+		ppc_dec_pages[idx] = dp;
+	}
+	memset(dp->slot, 0, sizeof dp->slot);
+	dp->page = page;
+	return dp;
+}
+
+static inline ppc_dec_slot *ppc_dec_fetch(ppc_dec_page *dp, uint32 pc)
+{
+	uint32 raw = *((uint32*)(&dp->page[pc & 0xfff]));
+	ppc_dec_slot *s = &dp->slot[(pc & 0xfff) >> 2];
+	if (!s->func || s->raw != raw) {
+		s->raw = raw;
+		s->opc = ppc_word_from_BE(raw);
+		s->func = ppc_dec_opc(s->opc);
+		s->sync = ppc_dec_is_sync(s->opc);
+	}
+	return s;
+}
+
+static void ppc_dec_free()
+{
+	for (int i = 0; i < PPC_DEC_PAGES; i++) {
+		free(ppc_dec_pages[i]);
+		ppc_dec_pages[i] = NULL;
+	}
+	ppc_dec_current = NULL;
+}
+
 void PPCCALL ppc_cpu_run_single(int count)
 {
 	while (count != 0) {
-		if (count > 0)
-			count--;
-		gCPU.npc = gCPU.pc+4;
-		if ((gCPU.pc & ~0xfff) == gCPU.effective_code_page) {
-			gCPU.current_opc = ppc_word_from_BE(*((uint32*)(&gCPU.physical_code_page[gCPU.pc & 0xfff])));
-			ppc_debug_hook();
-		} else {
+		if ((gCPU.pc & ~0xfff) != gCPU.effective_code_page) {
 			int ret;
+			if (count > 0)
+				count--;
+			gCPU.npc = gCPU.pc+4;
 			if ((ret = ppc_direct_effective_memory_handle_code(gCPU.pc & ~0xfff, gCPU.physical_code_page))) {
 				if (ret == PPC_MMU_EXC) {
 					gCPU.pc = gCPU.npc;
@@ -127,49 +209,52 @@ void PPCCALL ppc_cpu_run_single(int count)
 				}
 			}
 			gCPU.effective_code_page = gCPU.pc & ~0xfff;
+			ppc_dec_current = ppc_dec_get_page(gCPU.physical_code_page);
 			continue;
 		}
-		if (ppc_trace)
-			ht_printf("%08x %04x\n", gCPU.pc, gCPU.current_opc);
-		ppc_exec_opc();
-		ops++;
-		gCPU.ptb++;
-		ppc_do_dec(1);
-		if ((ops & 0x3ffff)==0) {
-/*			if (pic_check_interrupt()) {
-				gCPU.exception_pending = true;
-				gCPU.ext_exception = true;
-			}*/
-			if ((ops & 0x0fffff)==0) {
-//				uint32 j=0;
-//				ppc_read_effective_word(0xc046b2f8, j);
-
-				//ht_printf("@%08x (%u ops) pdec: %08x lr: %08x\n", gCPU.pc, ops, gCPU.pdec, gCPU.lr);
-#if 0
-				extern uint32 PIC_enable_low;
-				extern uint32 PIC_enable_high;
-				ht_printf("enable ");
-				int x = 1;
-				for (int i=0; i<31; i++) {
-					if (PIC_enable_low & x) {
-						ht_printf("%d ", i);
-		    			}
-					x<<=1;
-				}
-				x=1;
-				for (int i=0; i<31; i++) {
-					if (PIC_enable_high & x) {
-						ht_printf("%d ", 32+i);
-		    			}
-					x<<=1;
-				}
-				ht_printf("\n");
-#endif
+
+		// run straight line code up to a branch, exception or the end of the page
+		uint32 page = gCPU.effective_code_page;
+		int max = PPC_DEC_MAXBLOCK;
+		int n = 0;
+		if (count > 0 && count < max)
+			max = count;
+		if (ppc_trace || !ppc_dec_current || (gCPU.msr & MSR_SE))
+			max = 1;
+		for (;;) {
+			bool sync = false;
+			gCPU.npc = gCPU.pc+4;
+			if (ppc_dec_current) {
+				ppc_dec_slot *s = ppc_dec_fetch(ppc_dec_current, gCPU.pc);
+				sync = s->sync;
+				if (sync && n > 0)
+					break;
+				gCPU.current_opc = s->opc;
+				ppc_debug_hook();
+				if (ppc_trace)
+					ht_printf("%08x %04x\n", gCPU.pc, gCPU.current_opc);
+				s->func();
+			} else {
+				gCPU.current_opc = ppc_word_from_BE(*((uint32*)(&gCPU.physical_code_page[gCPU.pc & 0xfff])));
+				ppc_debug_hook();
+				if (ppc_trace)
+					ht_printf("%08x %04x\n", gCPU.pc, gCPU.current_opc);
+				ppc_exec_opc();
 			}
+			n++;
+			bool branch = gCPU.npc != gCPU.pc+4;
+			gCPU.pc = gCPU.npc;
+			if (branch || sync || n >= max || gCPU.exception_pending)
+				break;
+			if (gCPU.effective_code_page != page || !(gCPU.pc & 0xfff))
+				break;
 		}
-		
-		gCPU.pc = gCPU.npc;
-		
+		if (count > 0)
+			count -= n;
+		ops += n;
+		gCPU.ptb += n;
+		ppc_do_dec(n);
+
 		extern int debugger_active, pause_emulation;
 		extern void sleep_millis(int);
 		while ((debugger_active || pause_emulation) && count < 0) {
@@ -332,6 +417,8 @@ bool PPCCALL ppc_cpu_init(uint32 pvr)
 	gCPU.msr = MSR_IP;
 	
 	ppc_dec_init();
+	ppc_dec_free();
+	ppc_mmu_tlb_flush();
 	// initialize srs (mostly for prom)
 //	for (int i=0; i<16; i++) {
 //		gCPU.sr[i] = 0x2aa*i;
@@ -348,6 +435,11 @@ bool PPCCALL ppc_cpu_init(uint32 pvr)
 
 void PPCCALL ppc_cpu_free(void)
 {
+	uint64 hits[2], misses[2];
+	ppc_mmu_tlb_stats(hits, misses);
+	ht_printf("PPC TLB: itlb %lld hits %lld misses, dtlb %lld hits %lld misses\n",
+		hits[0], misses[0], hits[1], misses[1]);
+	ppc_dec_free();
 	sys_destroy_mutex(exception_mutex);
 }
 
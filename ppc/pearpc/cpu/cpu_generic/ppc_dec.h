@@ -27,6 +27,7 @@ void FASTCALL ppc_exec_opc();
 void ppc_dec_init();
 
 typedef void (*ppc_opc_function)();
+ppc_opc_function ppc_dec_opc(uint32 opc);
 
 #define PPC_OPC_ASSERT(v)
 
@@ -44,7 +44,139 @@ byte *gMemory = NULL;
 uint32 gMemorySize;
 #endif
 
-#undef TLB
+/*
+ *	Software TLB
+ *
+ *	Set associative, separate instruction and data sides. Entries are
+ *	tagged with the effective page, whether translation was enabled and
+ *	MSR[PR], so mode switches on exceptions and rfi don't need a flush.
+ *	Real mode, BAT and page table translations are all cached. Pages that
+ *	are plain RAM on the UAE side also keep a host pointer, and loads and
+ *	stores to those skip io_mem_read/io_mem_write. A page table entry only
+ *	becomes writable in the TLB once a store has set its C bit.
+ */
+
+#ifndef PPC_TLB_SETS
+#define PPC_TLB_SETS	64
+#endif
+#ifndef PPC_TLB_WAYS
+#define PPC_TLB_WAYS	4
+#endif
+
+#define PPC_TLB_VALID	1
+#define PPC_TLB_XLATE	2
+#define PPC_TLB_PR	4
+
+struct ppc_tlb_entry {
+	uint32 tag;
+	uint32 pa;
+	byte *host;
+	bool write;
+};
+
+struct ppc_tlb {
+	ppc_tlb_entry e[PPC_TLB_SETS][PPC_TLB_WAYS];
+	uint8 next[PPC_TLB_SETS];
+};
+
+static ppc_tlb ppc_itlb, ppc_dtlb;
+static uint64 ppc_tlb_hits[2], ppc_tlb_misses[2];
+static int ppc_tlb_generation;
+
+extern volatile int uae_ppc_memory_generation;
+extern bool uae_ppc_direct_ram(uint32, byte *&ptr);
+
+void ppc_mmu_tlb_flush()
+{
+	memset(&ppc_itlb, 0, sizeof ppc_itlb);
+	memset(&ppc_dtlb, 0, sizeof ppc_dtlb);
+	ppc_tlb_generation = uae_ppc_memory_generation;
+}
+
+static void ppc_tlb_flush_page(ppc_tlb *tlb, uint32 ea)
+{
+	ppc_tlb_entry *e = tlb->e[(ea >> 12) & (PPC_TLB_SETS - 1)];
+	for (int i=0; i<PPC_TLB_WAYS; i++) {
+		if ((e[i].tag & ~0xfff) == (ea & ~0xfff))
+			e[i].tag = 0;
+	}
+}
+
+void ppc_mmu_tlb_flush_page(uint32 ea)
+{
+	ppc_tlb_flush_page(&ppc_itlb, ea);
+	ppc_tlb_flush_page(&ppc_dtlb, ea);
+}
+
+void ppc_mmu_tlb_stats(uint64 *hits, uint64 *misses)
+{
+	hits[0] = ppc_tlb_hits[0];
+	hits[1] = ppc_tlb_hits[1];
+	misses[0] = ppc_tlb_misses[0];
+	misses[1] = ppc_tlb_misses[1];
+}
+
+static inline uint32 ppc_tlb_tag(uint32 addr, int flags)
+{
+	uint32 tag = (addr & ~0xfff) | PPC_TLB_VALID;
+	if (gCPU.msr & ((flags & PPC_MMU_CODE) ? MSR_IR : MSR_DR))
+		tag |= PPC_TLB_XLATE;
+	if (gCPU.msr & MSR_PR)
+		tag |= PPC_TLB_PR;
+	return tag;
+}
+
+static inline ppc_tlb_entry *ppc_tlb_lookup(uint32 addr, int flags)
+{
+	if (ppc_tlb_generation != uae_ppc_memory_generation)
+		ppc_mmu_tlb_flush();
+	ppc_tlb *tlb = (flags & PPC_MMU_CODE) ? &ppc_itlb : &ppc_dtlb;
+	ppc_tlb_entry *e = tlb->e[(addr >> 12) & (PPC_TLB_SETS - 1)];
+	uint32 tag = ppc_tlb_tag(addr, flags);
+	for (int i=0; i<PPC_TLB_WAYS; i++) {
+		if (e[i].tag == tag) {
+			if ((flags & PPC_MMU_WRITE) && !e[i].write)
+				return NULL;
+			return &e[i];
+		}
+	}
+	return NULL;
+}
+
+static void ppc_tlb_fill(uint32 addr, int flags, uint32 pa, bool write)
+{
+	ppc_tlb *tlb = (flags & PPC_MMU_CODE) ? &ppc_itlb : &ppc_dtlb;
+	uint set = (addr >> 12) & (PPC_TLB_SETS - 1);
+	ppc_tlb_entry *e = tlb->e[set];
+	uint32 tag = ppc_tlb_tag(addr, flags);
+	int i;
+	for (i=0; i<PPC_TLB_WAYS; i++) {
+		if (e[i].tag == tag)
+			break;
+	}
+	if (i == PPC_TLB_WAYS) {
+		i = tlb->next[set];
+		tlb->next[set] = (i + 1) % PPC_TLB_WAYS;
+	}
+	e += i;
+	e->tag = tag;
+	e->pa = pa & ~0xfff;
+	e->write = write;
+	if (!uae_ppc_direct_ram(e->pa, e->host))
+		e->host = NULL;
+}
+
+// host address of a RAM page access that doesn't cross the page, or NULL
+static inline byte *ppc_tlb_host(uint32 addr, int flags, int size)
+{
+	if (EA_Offset(addr) > 4096 - size)
+		return NULL;
+	ppc_tlb_entry *e = ppc_tlb_lookup(addr, flags);
+	if (!e || !e->host)
+		return NULL;
+	ppc_tlb_hits[(flags & PPC_MMU_CODE) ? 0 : 1]++;
+	return e->host + EA_Offset(addr);
+}
 
 static int ppc_pte_protection[] = {
 	// read(0)/write(1) key pp
@@ -75,9 +207,18 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 	static int lastibatcnt;
 	static int lastdbatcnt;
 
+	ppc_tlb_entry *e = ppc_tlb_lookup(addr, flags);
+	if (e) {
+		ppc_tlb_hits[(flags & PPC_MMU_CODE) ? 0 : 1]++;
+		result = e->pa | (addr & 0xfff);
+		return PPC_MMU_OK;
+	}
+	ppc_tlb_misses[(flags & PPC_MMU_CODE) ? 0 : 1]++;
+
 	if (flags & PPC_MMU_CODE) {
 		if (!(gCPU.msr & MSR_IR)) {
 			result = addr;
+			ppc_tlb_fill(addr, flags, result, true);
 			return PPC_MMU_OK;
 		}
 		/*
@@ -101,6 +242,7 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 					page |= BATL_BRPN(gCPU.ibatl[i] & bl17);
 					// fixme: check access rights
 					result = page | offset;
+					ppc_tlb_fill(addr, flags, result, true);
 					return PPC_MMU_OK;
 				}
 			}
@@ -110,6 +252,7 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 	} else {
 		if (!(gCPU.msr & MSR_DR)) {
 			result = addr;
+			ppc_tlb_fill(addr, flags, result, true);
 			return PPC_MMU_OK;
 		}
 		/*
@@ -133,6 +276,7 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 					page |= BATL_BRPN(gCPU.dbatl[i] & bl17);
 					// fixme: check access rights
 					result = page | offset;
+					ppc_tlb_fill(addr, flags, result, true);
 					return PPC_MMU_OK;
 				}
 			}
@@ -151,16 +295,6 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 		// FIXME: implement me
 		PPC_MMU_ERR("sr & T\n");
 	} else {
-#ifdef TLB	
-		for (int i=0; i<4; i++) {
-			if ((addr & ~0xfff) == (gCPU.tlb_va[i])) {
-				gCPU.tlb_last = i;
-//				ht_printf("TLB: %d: %08x -> %08x\n", i, addr, gCPU.tlb_pa[i] | (addr & 0xfff));
-				result = gCPU.tlb_pa[i] | (addr & 0xfff);
-				return PPC_MMU_OK;
-			}
-		}
-#endif
 		// page address translation
 		if ((flags & PPC_MMU_CODE) && (sr & SR_N)) {
 			// segment isnt executable
@@ -228,13 +362,7 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 					// ok..
 					uint32 pap = PTE2_RPN(pte);
 					result = pap | offset;
-#ifdef TLB
-					gCPU.tlb_last++;
-					gCPU.tlb_last &= 3;
-					gCPU.tlb_pa[gCPU.tlb_last] = pap;
-					gCPU.tlb_va[gCPU.tlb_last] = addr & ~0xfff;					
-//					ht_printf("TLB: STORE %d: %08x -> %08x\n", gCPU.tlb_last, addr, pap);
-#endif
+					ppc_tlb_fill(addr, flags, result, (flags & PPC_MMU_WRITE) != 0);
 					// update access bits
 					uint32 opte = pte;
 					if (flags & PPC_MMU_WRITE) {
@@ -298,6 +426,7 @@ inline int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &re
 					}
 					// ok..
 					result = PTE2_RPN(pte) | offset;
+					ppc_tlb_fill(addr, flags, result, (flags & PPC_MMU_WRITE) != 0);
 					
 					// update access bits
 					uint32 opte = pte;
@@ -371,6 +500,7 @@ bool FASTCALL ppc_mmu_set_sdr1(uint32 newval, bool quiesce)
 	}
 	gCPU.pagetable_base = htaborg<<16;
 	gCPU.sdr1 = newval;
+	ppc_mmu_tlb_flush();
 	gCPU.pagetable_hashmask = ((xx<<10)|0x3ff);
 	PPC_MMU_TRACE("new pagetable: sdr1 accepted\n");
 	PPC_MMU_TRACE("number of pages: 2^%d pagetable_start: 0x%08x size: 2^%d\n", n+13, gCPU.pagetable_base, n+16);
@@ -556,6 +686,11 @@ inline int FASTCALL ppc_read_effective_dword(uint32 addr, uint64 &result)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_READ, 8);
+	if (h) {
+		result = ppc_dword_from_BE(*((uint64*)h));
+		return PPC_MMU_OK;
+	}
 	if (!(r = ppc_effective_to_physical(addr, PPC_MMU_READ, p))) {
 		if (EA_Offset(addr) > 4088) {
 			// read overlaps two pages.. tricky
@@ -581,6 +716,11 @@ inline int FASTCALL ppc_read_effective_word(uint32 addr, uint32 &result)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_READ, 4);
+	if (h) {
+		result = ppc_word_from_BE(*((uint32*)h));
+		return PPC_MMU_OK;
+	}
 	if (!(r = ppc_effective_to_physical(addr, PPC_MMU_READ, p))) {
 		if (EA_Offset(addr) > 4092) {
 			// read overlaps two pages.. tricky
@@ -606,6 +746,11 @@ inline int FASTCALL ppc_read_effective_half(uint32 addr, uint16 &result)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_READ, 2);
+	if (h) {
+		result = ppc_half_from_BE(*((uint16*)h));
+		return PPC_MMU_OK;
+	}
 	if (!((r = ppc_effective_to_physical(addr, PPC_MMU_READ, p)))) {
 		if (EA_Offset(addr) > 4094) {
 			// read overlaps two pages.. tricky
@@ -627,6 +772,11 @@ inline int FASTCALL ppc_read_effective_byte(uint32 addr, uint8 &result)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_READ, 1);
+	if (h) {
+		result = *h;
+		return PPC_MMU_OK;
+	}
 	if (!((r = ppc_effective_to_physical(addr, PPC_MMU_READ, p)))) {
 		return ppc_read_physical_byte(p, result);
 	}
@@ -722,6 +872,11 @@ inline int FASTCALL ppc_write_effective_dword(uint32 addr, uint64 data)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_WRITE, 8);
+	if (h) {
+		*((uint64*)h) = ppc_dword_to_BE(data);
+		return PPC_MMU_OK;
+	}
 	if (!((r=ppc_effective_to_physical(addr, PPC_MMU_WRITE, p)))) {
 		if (EA_Offset(addr) > 4088) {
 			// write overlaps two pages.. tricky
@@ -749,6 +904,11 @@ inline int FASTCALL ppc_write_effective_word(uint32 addr, uint32 data)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_WRITE, 4);
+	if (h) {
+		*((uint32*)h) = ppc_word_to_BE(data);
+		return PPC_MMU_OK;
+	}
 	if (!((r=ppc_effective_to_physical(addr, PPC_MMU_WRITE, p)))) {
 		if (EA_Offset(addr) > 4092) {
 			// write overlaps two pages.. tricky
@@ -776,6 +936,11 @@ inline int FASTCALL ppc_write_effective_half(uint32 addr, uint16 data)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_WRITE, 2);
+	if (h) {
+		*((uint16*)h) = ppc_half_to_BE(data);
+		return PPC_MMU_OK;
+	}
 	if (!((r=ppc_effective_to_physical(addr, PPC_MMU_WRITE, p)))) {
 		if (EA_Offset(addr) > 4094) {
 			// write overlaps two pages.. tricky
@@ -795,6 +960,11 @@ inline int FASTCALL ppc_write_effective_byte(uint32 addr, uint8 data)
 {
 	uint32 p;
 	int r;
+	byte *h = ppc_tlb_host(addr, PPC_MMU_WRITE, 1);
+	if (h) {
+		*h = data;
+		return PPC_MMU_OK;
+	}
 	if (!((r=ppc_effective_to_physical(addr, PPC_MMU_WRITE, p)))) {
 		return ppc_write_physical_byte(p, data);
 	}
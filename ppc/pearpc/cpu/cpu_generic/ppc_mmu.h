@@ -40,6 +40,9 @@ extern uint32 gMemorySize;
 int FASTCALL ppc_effective_to_physical(uint32 addr, int flags, uint32 &result);
 bool FASTCALL ppc_mmu_set_sdr1(uint32 newval, bool quiesce);
 void ppc_mmu_tlb_invalidate();
+void ppc_mmu_tlb_flush();
+void ppc_mmu_tlb_flush_page(uint32 ea);
+void ppc_mmu_tlb_stats(uint64 *hits, uint64 *misses);
 
 int FASTCALL ppc_read_physical_dword(uint32 addr, uint64 &result);
 int FASTCALL ppc_read_physical_word(uint32 addr, uint32 &result);
@@ -696,58 +696,74 @@ void ppc_opc_mtspr()
 		case 16:
 			gCPU.ibatu[0] = gCPU.gpr[rS];
 			gCPU.ibat_bl17[0] = ~(BATU_BL(gCPU.ibatu[0])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 17:
 			gCPU.ibatl[0] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 18:
 			gCPU.ibatu[1] = gCPU.gpr[rS];
 			gCPU.ibat_bl17[1] = ~(BATU_BL(gCPU.ibatu[1])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 19:
 			gCPU.ibatl[1] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 20:
 			gCPU.ibatu[2] = gCPU.gpr[rS];
 			gCPU.ibat_bl17[2] = ~(BATU_BL(gCPU.ibatu[2])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 21:
 			gCPU.ibatl[2] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 22:
 			gCPU.ibatu[3] = gCPU.gpr[rS];
 			gCPU.ibat_bl17[3] = ~(BATU_BL(gCPU.ibatu[3])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 23:
 			gCPU.ibatl[3] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 24:
 			gCPU.dbatu[0] = gCPU.gpr[rS];
 			gCPU.dbat_bl17[0] = ~(BATU_BL(gCPU.dbatu[0])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 25:
 			gCPU.dbatl[0] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 26:
 			gCPU.dbatu[1] = gCPU.gpr[rS];
 			gCPU.dbat_bl17[1] = ~(BATU_BL(gCPU.dbatu[1])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 27:
 			gCPU.dbatl[1] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 28:
 			gCPU.dbatu[2] = gCPU.gpr[rS];
 			gCPU.dbat_bl17[2] = ~(BATU_BL(gCPU.dbatu[2])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 29:
 			gCPU.dbatl[2] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		case 30:
 			gCPU.dbatu[3] = gCPU.gpr[rS];
 			gCPU.dbat_bl17[3] = ~(BATU_BL(gCPU.dbatu[3])<<17);
+			ppc_mmu_tlb_flush();
 			return;
 		case 31:
 			gCPU.dbatl[3] = gCPU.gpr[rS];
+			ppc_mmu_tlb_flush();
 			return;
 		}
 		break;
@@ -806,6 +822,7 @@ void ppc_opc_mtsr()
 	PPC_OPC_TEMPL_X(gCPU.current_opc, rS, SR, rB);
 	// FIXME: check insn
 	gCPU.sr[SR & 0xf] = gCPU.gpr[rS];
+	ppc_mmu_tlb_flush();
 }
 /*
  *	mtsrin		Move to Segment Register Indirect
@@ -821,6 +838,7 @@ void ppc_opc_mtsrin()
 	PPC_OPC_TEMPL_X(gCPU.current_opc, rS, rA, rB);
 	// FIXME: check insn
 	gCPU.sr[gCPU.gpr[rB] >> 28] = gCPU.gpr[rS];
+	ppc_mmu_tlb_flush();
 }
 
 /*
@@ -861,7 +879,7 @@ void ppc_opc_sc()
  */
 void ppc_opc_sync()
 {
-	// NO-OP
+	// NO-OP, tlbie and friends already take effect immediately
 }
 
 /*
@@ -877,6 +895,7 @@ void ppc_opc_tlbia()
 	int rS, rA, rB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, rS, rA, rB);
 	// FIXME: check rS.. for 0
+	ppc_mmu_tlb_flush();
 	ppc_mmu_tlb_invalidate();
 }
 
@@ -893,6 +912,7 @@ void ppc_opc_tlbie()
 	int rS, rA, rB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, rS, rA, rB);
 	// FIXME: check rS.. for 0     
+	ppc_mmu_tlb_flush_page(gCPU.gpr[rB]);
 	ppc_mmu_tlb_invalidate();
 }
 
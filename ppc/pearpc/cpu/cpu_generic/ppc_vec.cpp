@@ -42,8 +42,72 @@
 #include "ppc_fpu.h"
 #include "ppc_vec.h"
 
+/* PPC_VEC_NO_SSE builds the scalar reference code only (ppc_vec_test.sh) */
+#if !defined(PPC_VEC_NO_SSE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_MSC_VER) && defined(_M_IX86)))
+#define PPC_VEC_SSE2
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define VEC_SSSE3_FUNC
+#else
+#include <cpuid.h>
+#define VEC_SSSE3_FUNC __attribute__((target("ssse3")))
+#endif
+#endif
+
 #define	SIGN32 0x80000000
 
+#ifdef PPC_VEC_SSE2
+
+/* The vector registers are kept as host order 128 bit values (see VECT_B),
+ * so element N of a PPC vector is lane 15-N, 7-N or 3-N of an SSE register
+ * and plain lane-wise operations need no byte swapping at all. The scalar
+ * code below each SSE2 block is kept as the reference implementation. */
+
+#define VEC_LOAD(n)		_mm_loadu_si128((const __m128i*)&gCPU.vr[n])
+#define VEC_STORE(n, v)		_mm_storeu_si128((__m128i*)&gCPU.vr[n], (v))
+#define VEC_LOADF(n)		_mm_loadu_ps(gCPU.vr[n].f)
+#define VEC_STOREF(n, v)	_mm_storeu_ps(gCPU.vr[n].f, (v))
+
+/* saturating result differs from the modulo one if any element saturated */
+static inline void VEC_SAT(__m128i sat, __m128i mod)
+{
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(sat, mod)) != 0xffff)
+		gCPU.vscr |= VSCR_SAT;
+}
+
+static int vec_ssse3 = -1;
+
+static bool vec_has_ssse3()
+{
+	if (vec_ssse3 < 0) {
+#ifdef _MSC_VER
+		int regs[4];
+		__cpuid(regs, 1);
+		vec_ssse3 = (regs[2] >> 9) & 1;
+#else
+		unsigned int a, b, c, d;
+		vec_ssse3 = __get_cpuid(1, &a, &b, &c, &d) ? (c >> 9) & 1 : 0;
+#endif
+	}
+	return vec_ssse3 != 0;
+}
+
+VEC_SSSE3_FUNC static void vec_perm_ssse3(int vrD, int vrA, int vrB, int vrC)
+{
+	__m128i sel = VEC_LOAD(vrC);
+	// element n lives in byte 15-n
+	__m128i idx = _mm_andnot_si128(sel, _mm_set1_epi8(0x0f));
+	__m128i a = _mm_shuffle_epi8(VEC_LOAD(vrA), idx);
+	__m128i b = _mm_shuffle_epi8(VEC_LOAD(vrB), idx);
+	__m128i m = _mm_set1_epi8(0x10);
+	m = _mm_cmpeq_epi8(_mm_and_si128(sel, m), m);
+	VEC_STORE(vrD, _mm_or_si128(_mm_and_si128(m, b), _mm_andnot_si128(m, a)));
+}
+
+#endif
+
 /*	PACK_PIXEL	Packs a uint32 pixel to uint16 pixel
  *	v.219
  */
@@ -179,6 +243,13 @@ void ppc_opc_vperm()
 	int sel;
 	Vector_t r;
 	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+
+#ifdef PPC_VEC_SSE2
+	if (vec_has_ssse3()) {
+		vec_perm_ssse3(vrD, vrA, vrB, vrC);
+		return;
+	}
+#endif
 	for (int i=0; i<16; i++) {
 		sel = gCPU.vr[vrC].b[i];
 		if (sel & 0x10)
@@ -197,9 +268,13 @@ void ppc_opc_vsel()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
-	uint64 mask, val;
 	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
 
+#ifdef PPC_VEC_SSE2
+	__m128i m = VEC_LOAD(vrC);
+	VEC_STORE(vrD, _mm_or_si128(_mm_and_si128(m, VEC_LOAD(vrB)), _mm_andnot_si128(m, VEC_LOAD(vrA))));
+#else
+	uint64 mask, val;
 	mask = gCPU.vr[vrC].d[0];
 	val = gCPU.vr[vrB].d[0] & mask;
 	val |= gCPU.vr[vrA].d[0] & ~mask;
@@ -209,6 +284,7 @@ void ppc_opc_vsel()
 	val = gCPU.vr[vrB].d[1] & mask;
 	val |= gCPU.vr[vrA].d[1] & ~mask;
 	gCPU.vr[vrD].d[1] = val;
+#endif
 }
 
 /*	vsrb		Vector Shift Right Byte
@@ -557,9 +633,12 @@ void ppc_opc_vmrghb()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	Vector_t r;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_unpackhi_epi8(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
+	Vector_t r;
 	VECT_B(r, 0) = VECT_B(gCPU.vr[vrA], 0);
 	VECT_B(r, 1) = VECT_B(gCPU.vr[vrB], 0);
 	VECT_B(r, 2) = VECT_B(gCPU.vr[vrA], 1);
@@ -578,6 +657,7 @@ void ppc_opc_vmrghb()
 	VECT_B(r,15) = VECT_B(gCPU.vr[vrB], 7);
 
 	gCPU.vr[vrD] = r;
+#endif
 }
 
 /*	vmrghh		Vector Merge High Half Word
@@ -587,9 +667,12 @@ void ppc_opc_vmrghh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	Vector_t r;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_unpackhi_epi16(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
+	Vector_t r;
 	VECT_H(r, 0) = VECT_H(gCPU.vr[vrA], 0);
 	VECT_H(r, 1) = VECT_H(gCPU.vr[vrB], 0);
 	VECT_H(r, 2) = VECT_H(gCPU.vr[vrA], 1);
@@ -600,6 +683,7 @@ void ppc_opc_vmrghh()
 	VECT_H(r, 7) = VECT_H(gCPU.vr[vrB], 3);
 
 	gCPU.vr[vrD] = r;
+#endif
 }
 
 /*	vmrghw		Vector Merge High Word
@@ -609,15 +693,19 @@ void ppc_opc_vmrghw()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	Vector_t r;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_unpackhi_epi32(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
+	Vector_t r;
 	VECT_W(r, 0) = VECT_W(gCPU.vr[vrA], 0);
 	VECT_W(r, 1) = VECT_W(gCPU.vr[vrB], 0);
 	VECT_W(r, 2) = VECT_W(gCPU.vr[vrA], 1);
 	VECT_W(r, 3) = VECT_W(gCPU.vr[vrB], 1);
 
 	gCPU.vr[vrD] = r;
+#endif
 }
 
 /*	vmrglb		Vector Merge Low Byte
@@ -627,9 +715,12 @@ void ppc_opc_vmrglb()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	Vector_t r;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_unpacklo_epi8(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
+	Vector_t r;
 	VECT_B(r, 0) = VECT_B(gCPU.vr[vrA], 8);
 	VECT_B(r, 1) = VECT_B(gCPU.vr[vrB], 8);
 	VECT_B(r, 2) = VECT_B(gCPU.vr[vrA], 9);
@@ -648,6 +739,7 @@ void ppc_opc_vmrglb()
 	VECT_B(r,15) = VECT_B(gCPU.vr[vrB],15);
 
 	gCPU.vr[vrD] = r;
+#endif
 }
 
 /*	vmrglh		Vector Merge Low Half Word
@@ -657,9 +749,12 @@ void ppc_opc_vmrglh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	Vector_t r;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_unpacklo_epi16(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
+	Vector_t r;
 	VECT_H(r, 0) = VECT_H(gCPU.vr[vrA], 4);
 	VECT_H(r, 1) = VECT_H(gCPU.vr[vrB], 4);
 	VECT_H(r, 2) = VECT_H(gCPU.vr[vrA], 5);
@@ -670,6 +765,7 @@ void ppc_opc_vmrglh()
 	VECT_H(r, 7) = VECT_H(gCPU.vr[vrB], 7);
 
 	gCPU.vr[vrD] = r;
+#endif
 }
 
 /*	vmrglw		Vector Merge Low Word
@@ -679,15 +775,19 @@ void ppc_opc_vmrglw()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	Vector_t r;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_unpacklo_epi32(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
+	Vector_t r;
 	VECT_W(r, 0) = VECT_W(gCPU.vr[vrA], 2);
 	VECT_W(r, 1) = VECT_W(gCPU.vr[vrB], 2);
 	VECT_W(r, 2) = VECT_W(gCPU.vr[vrA], 3);
 	VECT_W(r, 3) = VECT_W(gCPU.vr[vrB], 3);
 
 	gCPU.vr[vrD] = r;
+#endif
 }
 
 /*	vspltb		Vector Splat Byte
@@ -1218,13 +1318,17 @@ void ppc_opc_vaddubm()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint8 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_add_epi8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint8 res;
 	for (int i=0; i<16; i++) {
 		res = gCPU.vr[vrA].b[i] + gCPU.vr[vrB].b[i];
 		gCPU.vr[vrD].b[i] = res;
 	}
+#endif
 }
 
 /*	vadduhm		Vector Add Unsigned Half Word Modulo
@@ -1234,13 +1338,17 @@ void ppc_opc_vadduhm()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_add_epi16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint16 res;
 	for (int i=0; i<8; i++) {
 		res = gCPU.vr[vrA].h[i] + gCPU.vr[vrB].h[i];
 		gCPU.vr[vrD].h[i] = res;
 	}
+#endif
 }
 
 /*	vadduwm		Vector Add Unsigned Word Modulo
@@ -1250,13 +1358,17 @@ void ppc_opc_vadduwm()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_add_epi32(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint32 res;
 	for (int i=0; i<4; i++) {
 		res = gCPU.vr[vrA].w[i] + gCPU.vr[vrB].w[i];
 		gCPU.vr[vrD].w[i] = res;
 	}
+#endif
 }
 
 /*	vaddfp		Vector Add Float Point
@@ -1266,13 +1378,17 @@ void ppc_opc_vaddfp()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	float res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STOREF(vrD, _mm_add_ps(VEC_LOADF(vrA), VEC_LOADF(vrB)));
+#else
+	float res;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		res = gCPU.vr[vrA].f[i] + gCPU.vr[vrB].f[i];
 		gCPU.vr[vrD].f[i] = res;
 	}
+#endif
 }
 
 /*	vaddcuw		Vector Add Carryout Unsigned Word
@@ -1298,13 +1414,20 @@ void ppc_opc_vaddubs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_adds_epu8(a, b);
+	VEC_SAT(r, _mm_add_epi8(a, b));
+	VEC_STORE(vrD, r);
+#else
+	uint16 res;
 	for (int i=0; i<16; i++) {
 		res = (uint16)gCPU.vr[vrA].b[i] + (uint16)gCPU.vr[vrB].b[i];
 		gCPU.vr[vrD].b[i] = SATURATE_UB(res);
 	}
+#endif
 }
 
 /*	vaddsbs		Vector Add Signed Byte Saturate
@@ -1314,13 +1437,20 @@ void ppc_opc_vaddsbs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_adds_epi8(a, b);
+	VEC_SAT(r, _mm_add_epi8(a, b));
+	VEC_STORE(vrD, r);
+#else
+	sint16 res;
 	for (int i=0; i<16; i++) {
 		res = (sint16)gCPU.vr[vrA].sb[i] + (sint16)gCPU.vr[vrB].sb[i];
 		gCPU.vr[vrD].b[i] = SATURATE_SB(res);
 	}
+#endif
 }
 
 /*	vadduhs		Vector Add Unsigned Half Word Saturate
@@ -1330,13 +1460,20 @@ void ppc_opc_vadduhs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_adds_epu16(a, b);
+	VEC_SAT(r, _mm_add_epi16(a, b));
+	VEC_STORE(vrD, r);
+#else
+	uint32 res;
 	for (int i=0; i<8; i++) {
 		res = (uint32)gCPU.vr[vrA].h[i] + (uint32)gCPU.vr[vrB].h[i];
 		gCPU.vr[vrD].h[i] = SATURATE_UH(res);
 	}
+#endif
 }
 
 /*	vaddshs		Vector Add Signed Half Word Saturate
@@ -1346,13 +1483,20 @@ void ppc_opc_vaddshs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_adds_epi16(a, b);
+	VEC_SAT(r, _mm_add_epi16(a, b));
+	VEC_STORE(vrD, r);
+#else
+	sint32 res;
 	for (int i=0; i<8; i++) {
 		res = (sint32)gCPU.vr[vrA].sh[i] + (sint32)gCPU.vr[vrB].sh[i];
 		gCPU.vr[vrD].h[i] = SATURATE_SH(res);
 	}
+#endif
 }
 
 /*	vadduws		Vector Add Unsigned Word Saturate
@@ -1429,13 +1573,17 @@ void ppc_opc_vsububm()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint8 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_sub_epi8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint8 res;
 	for (int i=0; i<16; i++) {
 		res = gCPU.vr[vrA].b[i] - gCPU.vr[vrB].b[i];
 		gCPU.vr[vrD].b[i] = res;
 	}
+#endif
 }
 
 /*	vsubuhm		Vector Subtract Unsigned Half Word Modulo
@@ -1445,13 +1593,17 @@ void ppc_opc_vsubuhm()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_sub_epi16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint16 res;
 	for (int i=0; i<8; i++) {
 		res = gCPU.vr[vrA].h[i] - gCPU.vr[vrB].h[i];
 		gCPU.vr[vrD].h[i] = res;
 	}
+#endif
 }
 
 /*	vsubuwm		Vector Subtract Unsigned Word Modulo
@@ -1461,13 +1613,17 @@ void ppc_opc_vsubuwm()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_sub_epi32(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint32 res;
 	for (int i=0; i<4; i++) {
 		res = gCPU.vr[vrA].w[i] - gCPU.vr[vrB].w[i];
 		gCPU.vr[vrD].w[i] = res;
 	}
+#endif
 }
 
 /*	vsubfp		Vector Subtract Float Point
@@ -1477,13 +1633,17 @@ void ppc_opc_vsubfp()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	float res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STOREF(vrD, _mm_sub_ps(VEC_LOADF(vrA), VEC_LOADF(vrB)));
+#else
+	float res;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		res = gCPU.vr[vrA].f[i] - gCPU.vr[vrB].f[i];
 		gCPU.vr[vrD].f[i] = res;
 	}
+#endif
 }
 
 /*	vsubcuw		Vector Subtract Carryout Unsigned Word
@@ -1509,14 +1669,21 @@ void ppc_opc_vsububs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_subs_epu8(a, b);
+	VEC_SAT(r, _mm_sub_epi8(a, b));
+	VEC_STORE(vrD, r);
+#else
+	uint16 res;
 	for (int i=0; i<16; i++) {
 		res = (uint16)gCPU.vr[vrA].b[i] - (uint16)gCPU.vr[vrB].b[i];
 
 		gCPU.vr[vrD].b[i] = SATURATE_0B(res);
 	}
+#endif
 }
 
 /*	vsubsbs		Vector Subtract Signed Byte Saturate
@@ -1526,14 +1693,21 @@ void ppc_opc_vsubsbs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_subs_epi8(a, b);
+	VEC_SAT(r, _mm_sub_epi8(a, b));
+	VEC_STORE(vrD, r);
+#else
+	sint16 res;
 	for (int i=0; i<16; i++) {
 		res = (sint16)gCPU.vr[vrA].sb[i] - (sint16)gCPU.vr[vrB].sb[i];
 
 		gCPU.vr[vrD].sb[i] = SATURATE_SB(res);
 	}
+#endif
 }
 
 /*	vsubuhs		Vector Subtract Unsigned Half Word Saturate
@@ -1543,14 +1717,21 @@ void ppc_opc_vsubuhs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_subs_epu16(a, b);
+	VEC_SAT(r, _mm_sub_epi16(a, b));
+	VEC_STORE(vrD, r);
+#else
+	uint32 res;
 	for (int i=0; i<8; i++) {
 		res = (uint32)gCPU.vr[vrA].h[i] - (uint32)gCPU.vr[vrB].h[i];
 
 		gCPU.vr[vrD].h[i] = SATURATE_0H(res);
 	}
+#endif
 }
 
 /*	vsubshs		Vector Subtract Signed Half Word Saturate
@@ -1560,14 +1741,21 @@ void ppc_opc_vsubshs()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA), b = VEC_LOAD(vrB);
+	__m128i r = _mm_subs_epi16(a, b);
+	VEC_SAT(r, _mm_sub_epi16(a, b));
+	VEC_STORE(vrD, r);
+#else
+	sint32 res;
 	for (int i=0; i<8; i++) {
 		res = (sint32)gCPU.vr[vrA].sh[i] - (sint32)gCPU.vr[vrB].sh[i];
 
 		gCPU.vr[vrD].sh[i] = SATURATE_SH(res);
 	}
+#endif
 }
 
 /*	vsubuws		Vector Subtract Unsigned Word Saturate
@@ -2151,15 +2339,19 @@ void ppc_opc_vavgub()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_avg_epu8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint16 res;
 	for (int i=0; i<16; i++) {
 		res = (uint16)gCPU.vr[vrA].b[i] +
 			(uint16)gCPU.vr[vrB].b[i] + 1;
 
 		gCPU.vr[vrD].b[i] = (res >> 1);
 	}
+#endif
 }
 
 /*	vavguh		Vector Average Unsigned Half Word
@@ -2169,15 +2361,19 @@ void ppc_opc_vavguh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_avg_epu16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint32 res;
 	for (int i=0; i<8; i++) {
 		res = (uint32)gCPU.vr[vrA].h[i] +
 			(uint32)gCPU.vr[vrB].h[i] + 1;
 
 		gCPU.vr[vrD].h[i] = (res >> 1);
 	}
+#endif
 }
 
 /*	vavguw		Vector Average Unsigned Word
@@ -2205,15 +2401,21 @@ void ppc_opc_vavgsb()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi8((char)0x80);
+	__m128i r = _mm_avg_epu8(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias));
+	VEC_STORE(vrD, _mm_xor_si128(r, bias));
+#else
+	sint16 res;
 	for (int i=0; i<16; i++) {
 		res = (sint16)gCPU.vr[vrA].sb[i] +
 			(sint16)gCPU.vr[vrB].sb[i] + 1;
 
 		gCPU.vr[vrD].sb[i] = (res >> 1);
 	}
+#endif
 }
 
 /*	vavgsh		Vector Average Signed Half Word
@@ -2223,15 +2425,21 @@ void ppc_opc_vavgsh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint32 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi16((short)0x8000);
+	__m128i r = _mm_avg_epu16(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias));
+	VEC_STORE(vrD, _mm_xor_si128(r, bias));
+#else
+	sint32 res;
 	for (int i=0; i<8; i++) {
 		res = (sint32)gCPU.vr[vrA].sh[i] +
 			(sint32)gCPU.vr[vrB].sh[i] + 1;
 
 		gCPU.vr[vrD].sh[i] = (res >> 1);
 	}
+#endif
 }
 
 /*	vavgsw		Vector Average Signed Word
@@ -2259,9 +2467,12 @@ void ppc_opc_vmaxub()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint8 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_max_epu8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint8 res;
 	for (int i=0; i<16; i++) {
 		res = gCPU.vr[vrA].b[i];
 
@@ -2270,6 +2481,7 @@ void ppc_opc_vmaxub()
 
 		gCPU.vr[vrD].b[i] = res;
 	}
+#endif
 }
 
 /*	vmaxuh		Vector Maximum Unsigned Half Word
@@ -2279,9 +2491,13 @@ void ppc_opc_vmaxuh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i b = VEC_LOAD(vrB);
+	VEC_STORE(vrD, _mm_add_epi16(_mm_subs_epu16(VEC_LOAD(vrA), b), b));
+#else
+	uint16 res;
 	for (int i=0; i<8; i++) {
 		res = gCPU.vr[vrA].h[i];
 
@@ -2290,6 +2506,7 @@ void ppc_opc_vmaxuh()
 
 		gCPU.vr[vrD].h[i] = res;
 	}
+#endif
 }
 
 /*	vmaxuw		Vector Maximum Unsigned Word
@@ -2319,9 +2536,14 @@ void ppc_opc_vmaxsb()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint8 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi8((char)0x80);
+	__m128i r = _mm_max_epu8(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias));
+	VEC_STORE(vrD, _mm_xor_si128(r, bias));
+#else
+	sint8 res;
 	for (int i=0; i<16; i++) {
 		res = gCPU.vr[vrA].sb[i];
 
@@ -2330,6 +2552,7 @@ void ppc_opc_vmaxsb()
 
 		gCPU.vr[vrD].sb[i] = res;
 	}
+#endif
 }
 
 /*	vmaxsh		Vector Maximum Signed Half Word
@@ -2339,9 +2562,12 @@ void ppc_opc_vmaxsh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_max_epi16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	sint16 res;
 	for (int i=0; i<8; i++) {
 		res = gCPU.vr[vrA].sh[i];
 
@@ -2350,6 +2576,7 @@ void ppc_opc_vmaxsh()
 
 		gCPU.vr[vrD].sh[i] = res;
 	}
+#endif
 }
 
 /*	vmaxsw		Vector Maximum Signed Word
@@ -2379,9 +2606,12 @@ void ppc_opc_vmaxfp()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	float res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STOREF(vrD, _mm_max_ps(VEC_LOADF(vrB), VEC_LOADF(vrA)));
+#else
+	float res;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		res = gCPU.vr[vrA].f[i];
 
@@ -2390,6 +2620,7 @@ void ppc_opc_vmaxfp()
 
 		gCPU.vr[vrD].f[i] = res;
 	}
+#endif
 }
 
 /*	vminub		Vector Minimum Unsigned Byte
@@ -2399,9 +2630,12 @@ void ppc_opc_vminub()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint8 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_min_epu8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	uint8 res;
 	for (int i=0; i<16; i++) {
 		res = gCPU.vr[vrA].b[i];
 
@@ -2410,6 +2644,7 @@ void ppc_opc_vminub()
 
 		gCPU.vr[vrD].b[i] = res;
 	}
+#endif
 }
 
 /*	vminuh		Vector Minimum Unsigned Half Word
@@ -2419,9 +2654,13 @@ void ppc_opc_vminuh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	uint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i a = VEC_LOAD(vrA);
+	VEC_STORE(vrD, _mm_sub_epi16(a, _mm_subs_epu16(a, VEC_LOAD(vrB))));
+#else
+	uint16 res;
 	for (int i=0; i<8; i++) {
 		res = gCPU.vr[vrA].h[i];
 
@@ -2430,6 +2669,7 @@ void ppc_opc_vminuh()
 
 		gCPU.vr[vrD].h[i] = res;
 	}
+#endif
 }
 
 /*	vminuw		Vector Minimum Unsigned Word
@@ -2459,9 +2699,14 @@ void ppc_opc_vminsb()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint8 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi8((char)0x80);
+	__m128i r = _mm_min_epu8(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias));
+	VEC_STORE(vrD, _mm_xor_si128(r, bias));
+#else
+	sint8 res;
 	for (int i=0; i<16; i++) {
 		res = gCPU.vr[vrA].sb[i];
 
@@ -2470,6 +2715,7 @@ void ppc_opc_vminsb()
 
 		gCPU.vr[vrD].sb[i] = res;
 	}
+#endif
 }
 
 /*	vminsh		Vector Minimum Signed Half Word
@@ -2479,9 +2725,12 @@ void ppc_opc_vminsh()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	sint16 res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_min_epi16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	sint16 res;
 	for (int i=0; i<8; i++) {
 		res = gCPU.vr[vrA].sh[i];
 
@@ -2490,6 +2739,7 @@ void ppc_opc_vminsh()
 
 		gCPU.vr[vrD].sh[i] = res;
 	}
+#endif
 }
 
 /*	vminsw		Vector Minimum Signed Word
@@ -2519,9 +2769,12 @@ void ppc_opc_vminfp()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	float res;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STOREF(vrD, _mm_min_ps(VEC_LOADF(vrB), VEC_LOADF(vrA)));
+#else
+	float res;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		res = gCPU.vr[vrA].f[i];
 
@@ -2530,6 +2783,7 @@ void ppc_opc_vminfp()
 
 		gCPU.vr[vrD].f[i] = res;
 	}
+#endif
 }
 
 /*	vrfin		Vector Round to Floating-Point Integer Nearest
@@ -2780,8 +3034,12 @@ void ppc_opc_vand()
 	int vrD, vrA, vrB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_and_si128(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
 	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] & gCPU.vr[vrB].d[0];
 	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] & gCPU.vr[vrB].d[1];
+#endif
 }
 
 /*	vandc		Vector Logical AND with Complement
@@ -2793,8 +3051,12 @@ void ppc_opc_vandc()
 	int vrD, vrA, vrB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_andnot_si128(VEC_LOAD(vrB), VEC_LOAD(vrA)));
+#else
 	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] & ~gCPU.vr[vrB].d[0];
 	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] & ~gCPU.vr[vrB].d[1];
+#endif
 }
 
 /*	vor		Vector Logical OR
@@ -2806,8 +3068,12 @@ void ppc_opc_vor()
 	int vrD, vrA, vrB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_or_si128(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
 	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] | gCPU.vr[vrB].d[0];
 	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] | gCPU.vr[vrB].d[1];
+#endif
 }
 
 /*	vnor		Vector Logical NOR
@@ -2819,8 +3085,12 @@ void ppc_opc_vnor()
 	int vrD, vrA, vrB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_xor_si128(_mm_or_si128(VEC_LOAD(vrA), VEC_LOAD(vrB)), _mm_set1_epi32(-1)));
+#else
 	gCPU.vr[vrD].d[0] = ~(gCPU.vr[vrA].d[0] | gCPU.vr[vrB].d[0]);
 	gCPU.vr[vrD].d[1] = ~(gCPU.vr[vrA].d[1] | gCPU.vr[vrB].d[1]);
+#endif
 }
 
 /*	vxor		Vector Logical XOR
@@ -2832,8 +3102,12 @@ void ppc_opc_vxor()
 	int vrD, vrA, vrB;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_STORE(vrD, _mm_xor_si128(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
 	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] ^ gCPU.vr[vrB].d[0];
 	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] ^ gCPU.vr[vrB].d[1];
+#endif
 }
 
 #define CR_CR6		(0x00f0)
@@ -2842,6 +3116,23 @@ void ppc_opc_vxor()
 #define CR_CR6_NE	(1<<5)
 #define CR_CR6_EQ_SOME	(1<<4)
 
+#ifdef PPC_VEC_SSE2
+static inline void VEC_CMP(int vrD, __m128i r)
+{
+	VEC_STORE(vrD, r);
+	if (PPC_OPC_VRc & gCPU.current_opc) {
+		int m = _mm_movemask_epi8(r);
+		gCPU.cr &= ~CR_CR6;
+		if (m == 0xffff)
+			gCPU.cr |= CR_CR6_EQ | CR_CR6_EQ_SOME;
+		else if (m == 0)
+			gCPU.cr |= CR_CR6_NE | CR_CR6_NE_SOME;
+		else
+			gCPU.cr |= CR_CR6_EQ_SOME | CR_CR6_NE_SOME;
+	}
+}
+#endif
+
 /*	vcmpequbx	Vector Compare Equal-to Unsigned Byte
  *	v.160
  */
@@ -2849,9 +3140,12 @@ void ppc_opc_vcmpequbx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_cmpeq_epi8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<16; i++) {
 		if (gCPU.vr[vrA].b[i] == gCPU.vr[vrB].b[i]) {
 			gCPU.vr[vrD].b[i] = 0xff;
@@ -2868,6 +3162,7 @@ void ppc_opc_vcmpequbx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpequhx	Vector Compare Equal-to Unsigned Half Word
@@ -2877,9 +3172,12 @@ void ppc_opc_vcmpequhx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_cmpeq_epi16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<8; i++) {
 		if (gCPU.vr[vrA].h[i] == gCPU.vr[vrB].h[i]) {
 			gCPU.vr[vrD].h[i] = 0xffff;
@@ -2896,6 +3194,7 @@ void ppc_opc_vcmpequhx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpequwx	Vector Compare Equal-to Unsigned Word
@@ -2905,9 +3204,12 @@ void ppc_opc_vcmpequwx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_cmpeq_epi32(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<4; i++) {
 		if (gCPU.vr[vrA].w[i] == gCPU.vr[vrB].w[i]) {
 			gCPU.vr[vrD].w[i] = 0xffffffff;
@@ -2924,6 +3226,7 @@ void ppc_opc_vcmpequwx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpeqfpx	Vector Compare Equal-to-Floating Point
@@ -2933,9 +3236,12 @@ void ppc_opc_vcmpeqfpx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_castps_si128(_mm_cmpeq_ps(VEC_LOADF(vrA), VEC_LOADF(vrB))));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		if (gCPU.vr[vrA].f[i] == gCPU.vr[vrB].f[i]) {
 			gCPU.vr[vrD].w[i] = 0xffffffff;
@@ -2952,6 +3258,7 @@ void ppc_opc_vcmpeqfpx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtubx	Vector Compare Greater-Than Unsigned Byte
@@ -2961,9 +3268,13 @@ void ppc_opc_vcmpgtubx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi8((char)0x80);
+	VEC_CMP(vrD, _mm_cmpgt_epi8(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<16; i++) {
 		if (gCPU.vr[vrA].b[i] > gCPU.vr[vrB].b[i]) {
 			gCPU.vr[vrD].b[i] = 0xff;
@@ -2980,6 +3291,7 @@ void ppc_opc_vcmpgtubx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtsbx	Vector Compare Greater-Than Signed Byte
@@ -2989,9 +3301,12 @@ void ppc_opc_vcmpgtsbx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_cmpgt_epi8(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<16; i++) {
 		if (gCPU.vr[vrA].sb[i] > gCPU.vr[vrB].sb[i]) {
 			gCPU.vr[vrD].b[i] = 0xff;
@@ -3008,6 +3323,7 @@ void ppc_opc_vcmpgtsbx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtuhx	Vector Compare Greater-Than Unsigned Half Word
@@ -3017,9 +3333,13 @@ void ppc_opc_vcmpgtuhx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi16((short)0x8000);
+	VEC_CMP(vrD, _mm_cmpgt_epi16(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<8; i++) {
 		if (gCPU.vr[vrA].h[i] > gCPU.vr[vrB].h[i]) {
 			gCPU.vr[vrD].h[i] = 0xffff;
@@ -3036,6 +3356,7 @@ void ppc_opc_vcmpgtuhx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtshx	Vector Compare Greater-Than Signed Half Word
@@ -3045,9 +3366,12 @@ void ppc_opc_vcmpgtshx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_cmpgt_epi16(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<8; i++) {
 		if (gCPU.vr[vrA].sh[i] > gCPU.vr[vrB].sh[i]) {
 			gCPU.vr[vrD].h[i] = 0xffff;
@@ -3064,6 +3388,7 @@ void ppc_opc_vcmpgtshx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtuwx	Vector Compare Greater-Than Unsigned Word
@@ -3073,9 +3398,13 @@ void ppc_opc_vcmpgtuwx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	__m128i bias = _mm_set1_epi32((int)0x80000000);
+	VEC_CMP(vrD, _mm_cmpgt_epi32(_mm_xor_si128(VEC_LOAD(vrA), bias), _mm_xor_si128(VEC_LOAD(vrB), bias)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<4; i++) {
 		if (gCPU.vr[vrA].w[i] > gCPU.vr[vrB].w[i]) {
 			gCPU.vr[vrD].w[i] = 0xffffffff;
@@ -3092,6 +3421,7 @@ void ppc_opc_vcmpgtuwx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtswx	Vector Compare Greater-Than Signed Word
@@ -3101,9 +3431,12 @@ void ppc_opc_vcmpgtswx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_cmpgt_epi32(VEC_LOAD(vrA), VEC_LOAD(vrB)));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<4; i++) {
 		if (gCPU.vr[vrA].sw[i] > gCPU.vr[vrB].sw[i]) {
 			gCPU.vr[vrD].w[i] = 0xffffffff;
@@ -3120,6 +3453,7 @@ void ppc_opc_vcmpgtswx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgtfpx	Vector Compare Greater-Than Floating-Point
@@ -3129,9 +3463,12 @@ void ppc_opc_vcmpgtfpx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_castps_si128(_mm_cmpgt_ps(VEC_LOADF(vrA), VEC_LOADF(vrB))));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		if (gCPU.vr[vrA].f[i] > gCPU.vr[vrB].f[i]) {
 			gCPU.vr[vrD].w[i] = 0xffffffff;
@@ -3148,6 +3485,7 @@ void ppc_opc_vcmpgtfpx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpgefpx	Vector Compare Greater-Than-or-Equal-to Floating Point
@@ -3157,9 +3495,12 @@ void ppc_opc_vcmpgefpx()
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	int tf=CR_CR6_EQ | CR_CR6_NE;
 	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
 
+#ifdef PPC_VEC_SSE2
+	VEC_CMP(vrD, _mm_castps_si128(_mm_cmpge_ps(VEC_LOADF(vrA), VEC_LOADF(vrB))));
+#else
+	int tf=CR_CR6_EQ | CR_CR6_NE;
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
 		if (gCPU.vr[vrA].f[i] >= gCPU.vr[vrB].f[i]) {
 			gCPU.vr[vrD].w[i] = 0xffffffff;
@@ -3176,6 +3517,7 @@ void ppc_opc_vcmpgefpx()
 		gCPU.cr &= ~CR_CR6;
 		gCPU.cr |= tf;
 	}
+#endif
 }
 
 /*	vcmpbfpx	Vector Compare Bounds Floating Point
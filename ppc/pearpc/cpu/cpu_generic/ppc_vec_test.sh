@@ -0,0 +1,22 @@
+#!/bin/sh
+# Builds ppc_vec_test.cpp with and without the SSE paths and compares the
+# per instruction checksums. Usage: ppc_vec_test.sh [iterations]
+
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=${TMPDIR:-/tmp}/ppc_vec_test.$$
+INC="-I$DIR -I$DIR/../.. -I$DIR/../../../../include"
+
+mkdir -p "$TMP" || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+$CXX -O2 $INC -o "$TMP/sse" "$DIR/ppc_vec_test.cpp" || exit 1
+$CXX -O2 -DPPC_VEC_NO_SSE $INC -o "$TMP/ref" "$DIR/ppc_vec_test.cpp" || exit 1
+"$TMP/sse" "$@" > "$TMP/sse.txt" || exit 1
+"$TMP/ref" "$@" > "$TMP/ref.txt" || exit 1
+if diff "$TMP/ref.txt" "$TMP/sse.txt"; then
+	echo "ppc_vec: SSE and scalar results match"
+	exit 0
+fi
+echo "ppc_vec: SSE and scalar results differ (< scalar, > SSE)"
+exit 1
@@ -76,6 +76,46 @@ void uae_ppc_spinlock_release(void)
 #endif
 }
 
+/* PPC accesses to banks that are not thread safe are handed over to the
+ * 68k thread through a single slot mailbox (there is only one PPC thread)
+ * and executed at the points where the 68k thread used to drop the
+ * spinlock. Thread safe banks, which includes all RAM, never go near the
+ * spinlock or the mailbox. If the request isn't picked up quickly the PPC
+ * side falls back to taking the spinlock and doing the access itself. */
+
+#define PPC_IO_IDLE 0
+#define PPC_IO_POSTED 1
+#define PPC_IO_BUSY 2
+#define PPC_IO_DONE 3
+
+#define PPC_IO_SPIN 20000
+
+struct ppc_io_request
+{
+	volatile long state;
+	uint32_t addr;
+	uint64_t data;
+	int size;
+	bool write;
+};
+
+static struct ppc_io_request ppc_io;
+/* thread that is executing a PPC request, 0 if none */
+static volatile uintptr_t ppc_io_remote;
+
+#ifdef _WIN32
+#define ppc_io_cas(p, o, n) (InterlockedCompareExchange(p, n, o) == (o))
+#define ppc_io_barrier() MemoryBarrier()
+#define ppc_io_relax() YieldProcessor()
+#define ppc_io_self() ((uintptr_t)GetCurrentThreadId())
+#else
+#include <pthread.h>
+#define ppc_io_cas(p, o, n) __sync_bool_compare_and_swap(p, o, n)
+#define ppc_io_barrier() __sync_synchronize()
+#define ppc_io_relax()
+#define ppc_io_self() ((uintptr_t)pthread_self())
+#endif
+
 static void uae_ppc_spinlock_create(void)
 {
 #if SPINLOCK_DEBUG
@@ -326,9 +366,10 @@ static PPCLockStatus get_ppc_lock(PPCLockMethod method)
 
 		bool trylock_called = false;
 		while (true) {
-			if (ppc_spinlock_waiting) {
-				/* PPC CPU is waiting for the spinlock and the UAE side
-				 * owns the spinlock - no additional locking needed */
+			if (ppc_spinlock_waiting || ppc_io.state == PPC_IO_POSTED) {
+				/* PPC CPU is waiting for the spinlock or for its I/O
+				 * request and the UAE side owns the spinlock - no
+				 * additional locking needed */
 				if (trylock_called) {
 					impl.lock(QEMU_UAE_LOCK_TRYLOCK_CANCEL);
 				}
@@ -441,11 +482,22 @@ bool uae_self_is_ppc(void)
 {
 	if (ppc_state == PPC_STATE_INACTIVE)
 		return false;
+	if (ppc_io_remote && ppc_io_remote == ppc_io_self())
+		return true;
 	return impl.in_cpu_thread();
 }
 
+/* bumped on every memory map change, PearPC flushes its TLB host pointers */
+volatile int uae_ppc_memory_generation;
+
+void uae_ppc_memory_changed(void)
+{
+	uae_ppc_memory_generation++;
+}
+
 void ppc_map_banks(uae_u32 start, uae_u32 size, const TCHAR *name, void *addr, bool remove)
 {
+	uae_ppc_memory_changed();
 	if (ppc_state == PPC_STATE_INACTIVE || !impl.map_memory)
 		return;
 	PPCMemoryRegion r;
@@ -555,8 +607,109 @@ static void *ppc_thread(void *v)
 	return NULL;
 }
 
+static void ppc_io_execute(struct ppc_io_request *r)
+{
+	uint32_t addr = r->addr;
+	uint64_t data = r->data;
+
+	if (r->write) {
+		switch (r->size)
+		{
+		case 8:
+			put_long(addr + 0, data >> 32);
+			put_long(addr + 4, data & 0xffffffff);
+			break;
+		case 4:
+			put_long(addr, data);
+			break;
+		case 2:
+			put_word(addr, data);
+			break;
+		case 1:
+			put_byte(addr, data);
+			break;
+		}
+	} else {
+		switch (r->size)
+		{
+		case 8:
+			data = (uint64_t)get_long(addr + 0) << 32;
+			data |= get_long(addr + 4);
+			break;
+		case 4:
+			data = get_long(addr);
+			break;
+		case 2:
+			data = get_word(addr);
+			break;
+		case 1:
+			data = get_byte(addr);
+			break;
+		}
+		r->data = data;
+	}
+}
+
+static void ppc_io_complete(void)
+{
+	ppc_io_execute(&ppc_io);
+	ppc_io_barrier();
+	ppc_io.state = PPC_IO_DONE;
+}
+
+/* 68k thread side, spinlock is held */
+static void ppc_io_service(void)
+{
+	if (ppc_io.state != PPC_IO_POSTED)
+		return;
+	if (!ppc_io_cas(&ppc_io.state, PPC_IO_POSTED, PPC_IO_BUSY))
+		return;
+	ppc_io_remote = ppc_io_self();
+	ppc_io_complete();
+	ppc_io_remote = 0;
+}
+
+/* PPC thread side */
+static uint64_t ppc_io_access(uint32_t addr, uint64_t data, int size, bool write)
+{
+	addrbank *ab = &get_mem_bank(addr);
+
+	if (ab->flags & ABFLAG_THREADSAFE) {
+		struct ppc_io_request r;
+		r.addr = addr;
+		r.data = data;
+		r.size = size;
+		r.write = write;
+		ppc_io_execute(&r);
+		return r.data;
+	}
+	ppc_io.addr = addr;
+	ppc_io.data = data;
+	ppc_io.size = size;
+	ppc_io.write = write;
+	ppc_io_barrier();
+	ppc_io.state = PPC_IO_POSTED;
+	for (int i = 0; i < PPC_IO_SPIN && ppc_io.state != PPC_IO_DONE; i++)
+		ppc_io_relax();
+	if (ppc_io.state != PPC_IO_DONE) {
+		uae_ppc_spinlock_get();
+		if (ppc_io_cas(&ppc_io.state, PPC_IO_POSTED, PPC_IO_BUSY))
+			ppc_io_complete();
+		uae_ppc_spinlock_release();
+		/* 68k thread claimed it first and may drop the spinlock while
+		 * executing it (uae_ppc_cpu_stop), wait for its result. */
+		while (ppc_io.state != PPC_IO_DONE)
+			ppc_io_relax();
+	}
+	ppc_io_barrier();
+	data = ppc_io.data;
+	ppc_io.state = PPC_IO_IDLE;
+	return data;
+}
+
 void uae_ppc_execute_check(void)
 {
+	ppc_io_service();
 	if (ppc_spinlock_waiting) {
 		uae_ppc_spinlock_release();
 		uae_ppc_spinlock_get();
@@ -565,6 +718,7 @@ void uae_ppc_execute_check(void)
 
 void uae_ppc_execute_quick()
 {
+	ppc_io_service();
 	uae_ppc_spinlock_release();
 	sleep_millis_main(1);
 	uae_ppc_spinlock_get();
@@ -587,26 +741,21 @@ bool uae_ppc_direct_physical_memory_handle(uint32_t addr, uint8_t *&ptr)
 	return true;
 }
 
-STATIC_INLINE bool spinlock_pre(uaecptr addr)
+/* 4k page that can be accessed directly without going through the handlers.
+ * Only ABFLAG_DIRECTACCESS banks, hooked chip RAM and memwatch banks clear it. */
+bool uae_ppc_direct_ram(uint32_t addr, uint8_t *&ptr)
 {
 	addrbank *ab = &get_mem_bank(addr);
-	if ((ab->flags & ABFLAG_THREADSAFE) == 0) {
-		uae_ppc_spinlock_get();
-		return true;
-	}
-	return false;
-}
-
-STATIC_INLINE void spinlock_post(bool locked)
-{
-	if (locked)
-		uae_ppc_spinlock_release();
+	if ((ab->flags & (ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS | ABFLAG_INDIRECT)) != (ABFLAG_RAM | ABFLAG_THREADSAFE | ABFLAG_DIRECTACCESS))
+		return false;
+	if (!ab->baseaddr || !ab->check(addr, 4096))
+		return false;
+	ptr = get_real_address(addr);
+	return ptr != NULL;
 }
 
 bool UAECALL uae_ppc_io_mem_write(uint32_t addr, uint32_t data, int size)
 {
-	bool locked = false;
-
 	while (ppc_thread_running && ppc_cpu_lock_state < 0 && ppc_state);
 
 #if PPC_ACCESS_LOG > 0 && PPC_ACCESS_LOG < 2
@@ -616,20 +765,7 @@ bool UAECALL uae_ppc_io_mem_write(uint32_t addr, uint32_t data, int size)
 	}
 #endif
 
-	locked = spinlock_pre(addr);
-	switch (size)
-	{
-	case 4:
-		put_long(addr, data);
-		break;
-	case 2:
-		put_word(addr, data);
-		break;
-	case 1:
-		put_byte(addr, data);
-		break;
-	}
-	spinlock_post(locked);
+	ppc_io_access(addr, data, size, true);
 
 #if PPC_ACCESS_LOG >= 2
 	write_log(_T("PPC write %08x = %08x %d\n"), addr, data, size);
@@ -641,7 +777,6 @@ bool UAECALL uae_ppc_io_mem_write(uint32_t addr, uint32_t data, int size)
 bool UAECALL uae_ppc_io_mem_read(uint32_t addr, uint32_t *data, int size)
 {
 	uint32_t v;
-	bool locked = false;
 
 	while (ppc_thread_running && ppc_cpu_lock_state < 0 && ppc_state);
 
@@ -657,21 +792,8 @@ bool UAECALL uae_ppc_io_mem_read(uint32_t addr, uint32_t *data, int size)
 		}
 	}
 
-	locked = spinlock_pre(addr);
-	switch (size)
-	{
-	case 4:
-		v = get_long(addr);
-		break;
-	case 2:
-		v = get_word(addr);
-		break;
-	case 1:
-		v = get_byte(addr);
-		break;
-	}
+	v = (uint32_t)ppc_io_access(addr, 0, size, false);
 	*data = v;
-	spinlock_post(locked);
 
 #if PPC_ACCESS_LOG > 0 && PPC_ACCESS_LOG < 2
 	if (!valid_address(addr, size)) {
@@ -687,14 +809,9 @@ bool UAECALL uae_ppc_io_mem_read(uint32_t addr, uint32_t *data, int size)
 
 bool UAECALL uae_ppc_io_mem_write64(uint32_t addr, uint64_t data)
 {
-	bool locked = false;
-
 	while (ppc_thread_running && ppc_cpu_lock_state < 0 && ppc_state);
 
-	locked = spinlock_pre(addr);
-	put_long(addr + 0, data >> 32);
-	put_long(addr + 4, data & 0xffffffff);
-	spinlock_post(locked);
+	ppc_io_access(addr, data, 8, true);
 
 #if PPC_ACCESS_LOG >= 2
 	write_log(_T("PPC mem write64 %08x = %08llx\n"), addr, data);
@@ -705,16 +822,9 @@ bool UAECALL uae_ppc_io_mem_write64(uint32_t addr, uint64_t data)
 
 bool UAECALL uae_ppc_io_mem_read64(uint32_t addr, uint64_t *data)
 {
-	bool locked = false;
-	uint32_t v1, v2;
-
 	while (ppc_thread_running && ppc_cpu_lock_state < 0 && ppc_state);
 
-	locked = spinlock_pre(addr);
-	v1 = get_long(addr + 0);
-	v2 = get_long(addr + 4);
-	*data = ((uint64_t)v1 << 32) | v2;
-	spinlock_post(locked);
+	*data = ppc_io_access(addr, 0, 8, false);
 
 #if PPC_ACCESS_LOG >= 2
 	write_log(_T("PPC mem read64 %08x = %08llx\n"), addr, *data);
@@ -875,6 +875,18 @@ struct romdata *getromdatabyidgroup (int id, int group, int subitem)
 	return 0;
 }
 
+/* changes whenever the ROM table does, invalidates cached ROM scan results */
+uae_u32 getromdatasignature (void)
+{
+	uae_u32 sig = 0;
+	int i = 0;
+	while (roms[i].name) {
+		sig = sig * 31 + (roms[i].id ^ roms[i].group ^ roms[i].size ^ roms[i].crc32);
+		i++;
+	}
+	return sig ^ i;
+}
+
 STATIC_INLINE int notcrc32 (uae_u32 crc32)
 {
 	if (crc32 == 0xffffffff || crc32 == 0x00000000)
@@ -90,12 +90,29 @@ struct staterecord
 	int inuse;
 	uae_u8 *cpu;
 	uae_u8 *data;
+	uae_u8 *ram;
 	uae_u8 *end;
 	int inprecoffset;
+	bool keyframe;
 };
 
 static struct staterecord **staterecords;
 
+/* RAM is stored as full keyframes every REWIND_KEYFRAME captures,
+ * in between only pages that differ from the previous capture.
+ * The oldest record in the buffer is always kept as a keyframe.
+ */
+#define REWIND_PAGE_SIZE 4096
+#define REWIND_KEYFRAME 50
+#define REWIND_RAM_REGIONS 4
+struct rewind_shadow
+{
+	uae_u8 *data;
+	int len;
+};
+static struct rewind_shadow rewind_shadows[REWIND_RAM_REGIONS];
+static int rewind_keyframe_cnt;
+
 static void state_incompatible_warn (void)
 {
 	static int warned;
@@ -1176,6 +1193,128 @@ bool savestate_check (void)
 static int rewindmode;
 
 
+static uae_u8 *rewind_ram (int idx, int *len)
+{
+	switch (idx)
+	{
+	case 0:
+		return save_cram (len);
+	case 1:
+		return save_bram (len);
+#ifdef AUTOCONFIG
+	case 2:
+		return save_fram (len, 0);
+	case 3:
+		return save_zram (len, 0);
+#endif
+	}
+	*len = 0;
+	return NULL;
+}
+
+static void rewind_shadow_free (void)
+{
+	for (int i = 0; i < REWIND_RAM_REGIONS; i++) {
+		xfree (rewind_shadows[i].data);
+		rewind_shadows[i].data = NULL;
+		rewind_shadows[i].len = 0;
+	}
+	rewind_keyframe_cnt = 0;
+}
+
+/* previous keyframe record, -1 if it already dropped out of the buffer */
+static int rewind_find_keyframe (int pos)
+{
+	for (;;) {
+		struct staterecord *st = staterecords[pos];
+		if (st == NULL || !st->inuse)
+			return -1;
+		if (st->keyframe)
+			return pos;
+		if (pos == staterecords_first)
+			return -1;
+		pos--;
+		if (pos < 0)
+			pos += staterecords_max;
+	}
+}
+
+/* keyframe in slot oldpos is about to be reused, turn the oldest
+ * surviving record newpos into a keyframe so it stays rewindable
+ */
+static void rewind_promote_keyframe (int oldpos, int newpos)
+{
+	struct staterecord *kf = staterecords[oldpos];
+	struct staterecord *st = staterecords[newpos];
+	struct staterecord *nst;
+	uae_u8 *p, *q;
+	int ramlen, headlen, taillen;
+
+	if (oldpos == newpos || !kf || !st || !kf->inuse || !st->inuse)
+		return;
+	if (!kf->keyframe || st->keyframe)
+		return;
+	ramlen = 0;
+	p = kf->ram;
+	for (int i = 0; i < REWIND_RAM_REGIONS; i++) {
+		int len = restore_u32_func (&p);
+		restore_u32_func (&p);
+		p += len;
+		ramlen += len + 8;
+	}
+	q = st->ram;
+	for (int i = 0; i < REWIND_RAM_REGIONS; i++) {
+		int len = restore_u32_func (&q);
+		if (restore_u32_func (&q)) {
+			int pages = restore_u32_func (&q);
+			for (int j = 0; j < pages; j++) {
+				int offset = restore_u32_func (&q) * REWIND_PAGE_SIZE;
+				q += len - offset > REWIND_PAGE_SIZE ? REWIND_PAGE_SIZE : len - offset;
+			}
+		} else {
+			q += len;
+		}
+	}
+	headlen = st->ram - st->data;
+	taillen = st->end - q;
+	nst = (struct staterecord*)xmalloc (uae_u8, sizeof (struct staterecord) + headlen + ramlen + taillen);
+	if (!nst)
+		return;
+	*nst = *st;
+	nst->len = sizeof (struct staterecord) + headlen + ramlen + taillen;
+	nst->data = (uae_u8*)(nst + 1);
+	memcpy (nst->data, st->data, headlen);
+	nst->cpu = nst->data + (st->cpu - st->data);
+	nst->ram = nst->data + headlen;
+	memcpy (nst->ram, kf->ram, ramlen);
+	p = nst->ram;
+	q = st->ram;
+	for (int i = 0; i < REWIND_RAM_REGIONS; i++) {
+		int len = restore_u32_func (&p);
+		int dlen = restore_u32_func (&q);
+		restore_u32_func (&p);
+		if (restore_u32_func (&q)) {
+			int pages = restore_u32_func (&q);
+			for (int j = 0; j < pages; j++) {
+				int offset = restore_u32_func (&q) * REWIND_PAGE_SIZE;
+				int size = dlen - offset > REWIND_PAGE_SIZE ? REWIND_PAGE_SIZE : dlen - offset;
+				if (offset + size <= len)
+					memcpy (p + offset, q, size);
+				q += size;
+			}
+		} else {
+			memcpy (p, q, len > dlen ? dlen : len);
+			q += dlen;
+		}
+		p += len;
+	}
+	memcpy (p, q, taillen);
+	nst->end = p + taillen;
+	nst->keyframe = true;
+	xfree (st);
+	staterecords[newpos] = nst;
+}
+
 static struct staterecord *canrewind (int pos)
 {
 	if (pos < 0)
@@ -1188,9 +1327,51 @@ static struct staterecord *canrewind (int pos)
 		return NULL;
 	if ((pos + 1) % staterecords_max  == staterecords_first)
 		return NULL;
+	if (rewind_find_keyframe (pos) < 0)
+		return NULL;
 	return staterecords[pos];
 }
 
+static uae_u8 *restore_rewind_ram (uae_u8 *p)
+{
+	for (int i = 0; i < REWIND_RAM_REGIONS; i++) {
+		int len, alloc;
+		uae_u8 *dst = rewind_ram (i, &alloc);
+		len = restore_u32_func (&p);
+		if (restore_u32_func (&p)) {
+			int pages = restore_u32_func (&p);
+			for (int j = 0; j < pages; j++) {
+				int offset = restore_u32_func (&p) * REWIND_PAGE_SIZE;
+				int size = len - offset > REWIND_PAGE_SIZE ? REWIND_PAGE_SIZE : len - offset;
+				if (dst && offset + size <= alloc)
+					memcpy (dst + offset, p, size);
+				p += size;
+			}
+		} else {
+			if (dst)
+				memcpy (dst, p, alloc > len ? len : alloc);
+			p += len;
+		}
+	}
+	return p;
+}
+
+/* rebuild RAM of record pos from its keyframe and following deltas */
+static uae_u8 *restore_rewind_ram_chain (int pos)
+{
+	if (pos < 0)
+		pos += staterecords_max;
+	int i = rewind_find_keyframe (pos);
+	for (;;) {
+		uae_u8 *p = restore_rewind_ram (staterecords[i]->ram);
+		if (i == pos)
+			return p;
+		i++;
+		if (i >= staterecords_max)
+			i -= staterecords_max;
+	}
+}
+
 int savestate_dorewind (int pos)
 {
 	rewindmode = pos;
@@ -1230,7 +1411,7 @@ void savestate_listrewind (void)
 
 void savestate_rewind (void)
 {
-	int len, i, dummy;
+	int i;
 	uae_u8 *p, *p2;
 	struct staterecord *st;
 	int pos;
@@ -1293,20 +1474,9 @@ void savestate_rewind (void)
 	if (restore_u32_func (&p))
 		p = restore_p96 (p);
 #endif
-	len = restore_u32_func (&p);
-	memcpy (chipmem_bank.baseaddr, p, currprefs.chipmem_size > len ? len : currprefs.chipmem_size);
-	p += len;
-	len = restore_u32_func (&p);
-	memcpy (save_bram (&dummy), p, currprefs.bogomem_size > len ? len : currprefs.bogomem_size);
-	p += len;
-#ifdef AUTOCONFIG
-	len = restore_u32_func (&p);
-	memcpy (save_fram (&dummy, 0), p, currprefs.fastmem_size > len ? len : currprefs.fastmem_size);
-	p += len;
-	len = restore_u32_func (&p);
-	memcpy (save_zram (&dummy, 0), p, currprefs.z3fastmem_size > len ? len : currprefs.z3fastmem_size);
-	p += len;
-#endif
+	p = restore_rewind_ram_chain (pos);
+	// shadow no longer matches restored RAM
+	rewind_keyframe_cnt = 0;
 #ifdef ACTION_REPLAY
 	if (restore_u32_func (&p))
 		p = restore_action_replay (p);
@@ -1375,7 +1545,7 @@ void savestate_memorysave (void)
 void savestate_capture (int force)
 {
 	uae_u8 *p, *p2, *p3, *dst;
-	int i, len, tlen, retrycnt;
+	int i, len, tlen, tlen2, retrycnt;
 	struct staterecord *st;
 	bool firstcapture = false;
 
@@ -1403,6 +1573,15 @@ void savestate_capture (int force)
 	}
 	savestate_first_capture = false;
 
+	// keyframes need room for all RAM
+	tlen2 = STATEFILE_ALLOC_SIZE;
+	for (i = 0; i < REWIND_RAM_REGIONS; i++) {
+		if (rewind_ram (i, &len))
+			tlen2 += len + (len / REWIND_PAGE_SIZE + 1) * 4 + 12;
+	}
+	if (statefile_alloc < tlen2)
+		statefile_alloc = tlen2;
+
 	retrycnt = 0;
 retry2:
 	st = staterecords[replaycounter];
@@ -1414,6 +1593,11 @@ retry2:
 		st->len += STATEFILE_ALLOC_SIZE;
 		st = (struct staterecord*)xrealloc (uae_u8, st, st->len);
 	}
+	if (st->len < statefile_alloc) {
+		// previously shrunk delta record
+		st = (struct staterecord*)xrealloc (uae_u8, st, statefile_alloc);
+		st->len = statefile_alloc;
+	}
 	if (st->len > statefile_alloc)
 		statefile_alloc = st->len;
 	st->inuse = 0;
@@ -1502,7 +1686,8 @@ retry2:
 	tlen += len;
 	p += len;
 
-	if (bufcheck (st, p, 0))
+	// event2 pool can grow, at most 13 bytes per pending event
+	if (bufcheck (st, p, 8 + event2_count * 13))
 		goto retry;
 	p3 = p;
 	save_u32_func (&p, 0);
@@ -1585,36 +1770,64 @@ retry2:
 	}
 #endif
 
-	dst = save_cram (&len);
-	if (bufcheck (st, p, len))
-		goto retry;
-	save_u32_func (&p, len);
-	memcpy (p, dst, len);
-	tlen += len + 4;
-	p += len;
-	dst = save_bram (&len);
-	if (bufcheck (st, p, len))
-		goto retry;
-	save_u32_func (&p, len);
-	memcpy (p, dst, len);
-	tlen += len + 4;
-	p += len;
-#ifdef AUTOCONFIG
-	dst = save_fram (&len, 0);
-	if (bufcheck (st, p, len))
-		goto retry;
-	save_u32_func (&p, len);
-	memcpy (p, dst, len);
-	tlen += len + 4;
-	p += len;
-	dst = save_zram (&len, 0);
-	if (bufcheck (st, p, len))
+	st->ram = p;
+	st->keyframe = rewind_keyframe_cnt <= 0;
+	tlen2 = 0;
+	for (i = 0; i < REWIND_RAM_REGIONS; i++) {
+		dst = rewind_ram (i, &len);
+		if (dst)
+			tlen2 += len + (len / REWIND_PAGE_SIZE + 1) * 4 + 12;
+	}
+	if (bufcheck (st, p, tlen2))
 		goto retry;
-	save_u32_func (&p, len);
-	memcpy (p, dst, len);
-	tlen += len + 4;
-	p += len;
-#endif
+	for (i = 0; i < REWIND_RAM_REGIONS; i++) {
+		struct rewind_shadow *rs = &rewind_shadows[i];
+		dst = rewind_ram (i, &len);
+		if (!dst)
+			len = 0;
+		if (rs->len != len) {
+			xfree (rs->data);
+			rs->data = len ? xmalloc (uae_u8, len) : NULL;
+			rs->len = rs->data ? len : 0;
+			st->keyframe = true;
+		}
+	}
+	for (i = 0; i < REWIND_RAM_REGIONS; i++) {
+		struct rewind_shadow *rs = &rewind_shadows[i];
+		dst = rewind_ram (i, &len);
+		if (!dst)
+			len = 0;
+		save_u32_func (&p, len);
+		if (st->keyframe || !rs->data) {
+			save_u32_func (&p, 0);
+			memcpy (p, dst, len);
+			if (rs->data)
+				memcpy (rs->data, dst, len);
+			tlen += len + 8;
+			p += len;
+		} else {
+			int pages = 0;
+			save_u32_func (&p, 1);
+			p3 = p;
+			save_u32_func (&p, 0);
+			tlen += 12;
+			for (int offset = 0; offset < len; offset += REWIND_PAGE_SIZE) {
+				int size = len - offset > REWIND_PAGE_SIZE ? REWIND_PAGE_SIZE : len - offset;
+				if (!memcmp (dst + offset, rs->data + offset, size))
+					continue;
+				memcpy (rs->data + offset, dst + offset, size);
+				save_u32_func (&p, offset / REWIND_PAGE_SIZE);
+				memcpy (p, dst + offset, size);
+				tlen += size + 4;
+				p += size;
+				pages++;
+			}
+			save_u32_func (&p3, pages);
+		}
+	}
+	if (st->keyframe)
+		rewind_keyframe_cnt = REWIND_KEYFRAME;
+	rewind_keyframe_cnt--;
 #ifdef ACTION_REPLAY
 	if (bufcheck (st, p, 0))
 		goto retry;
@@ -1720,6 +1933,20 @@ retry2:
 	st->inuse = 1;
 	st->inprecoffset = inprec_getposition ();
 
+	if (!st->keyframe && st->end - (uae_u8*)st < st->len) {
+		// keep only the used part of delta records
+		int cpuoffset = st->cpu - st->data;
+		int ramoffset = st->ram - st->data;
+		int endoffset = st->end - st->data;
+		st->len = st->end - (uae_u8*)st;
+		st = (struct staterecord*)xrealloc (uae_u8, st, st->len);
+		st->data = (uae_u8*)(st + 1);
+		st->cpu = st->data + cpuoffset;
+		st->ram = st->data + ramoffset;
+		st->end = st->data + endoffset;
+		staterecords[replaycounter] = st;
+	}
+
 	replaycounter++;
 	if (replaycounter >= staterecords_max)
 		replaycounter -= staterecords_max;
@@ -1729,10 +1956,14 @@ retry2:
 			staterecords_first -= staterecords_max;
 	}
 
-	write_log (_T("state capture %d (%010d/%03d,%d/%d) (%d bytes, alloc %d)\n"),
+	write_log (_T("state capture %d (%010d/%03d,%d/%d) (%d bytes%s, alloc %d)\n"),
 		replaycounter, hsync_counter, vsync_counter,
 		hsync_counter % current_maxvpos (), current_maxvpos (),
-		st->end - st->data, statefile_alloc);
+		st->end - st->data, st->keyframe ? _T(" keyframe") : _T(""), statefile_alloc);
+
+	// buffer is full, the oldest record's keyframe gets overwritten next
+	if ((replaycounter + 1) % staterecords_max == staterecords_first)
+		rewind_promote_keyframe (replaycounter, staterecords_first);
 
 	if (firstcapture) {
 		savestate_memorysave ();
@@ -1748,6 +1979,8 @@ retry2:
 
 	return;
 retry:
+	// shadow may already contain this capture's RAM
+	rewind_keyframe_cnt = 0;
 	if (retrycnt < 10)
 		goto retry2;
 	write_log (_T("can't save, too small capture buffer or out of memory\n"));
@@ -1758,6 +1991,7 @@ void savestate_free (void)
 {
 	xfree (staterecords);
 	staterecords = NULL;
+	rewind_shadow_free ();
 }
 
 void savestate_capture_request (void)
@@ -0,0 +1,865 @@
+/*
+ * uaediskconv
+ *
+ * Batch conversion and verification of floppy disk images.
+ *
+ * Images are opened through zfile (archives, gzip, xz and DMS), raw
+ * formats are read with the same FDI, IPF and SCP decoders the emulator
+ * uses and MFM tracks are decoded with diskutil. No Kickstart or
+ * emulation core is needed.
+ *
+ * zfile, the DMS unpacker and the CAPS library keep global state, so
+ * opening and unpacking is serialized. Each SCP drive slot has its own
+ * lock. MFM decoding, CRC checks, MFM encoding and writing the output
+ * run in parallel on all worker threads.
+ */
+
+#include <stdio.h>
+#include <tchar.h>
+
+#include <windows.h>
+
+#include "sysconfig.h"
+#include "sysdeps.h"
+#include "options.h"
+#include "zfile.h"
+#include "crc32.h"
+#include "diskutil.h"
+#include "fdi2raw.h"
+#include "scp.h"
+#ifdef CAPS
+#include "caps/caps_win32.h"
+#endif
+
+TCHAR start_path_exe[MAX_DPATH];
+TCHAR start_path_data[MAX_DPATH];
+
+struct uae_prefs currprefs;
+static int verbose;
+static CRITICAL_SECTION log_cs;
+
+#define WRITE_LOG_BUF_SIZE 4096
+void write_log (const TCHAR *format, ...)
+{
+	TCHAR buffer[WRITE_LOG_BUF_SIZE];
+	va_list parms;
+	va_start (parms, format);
+	if (verbose) {
+		_vsntprintf (buffer, WRITE_LOG_BUF_SIZE - 1, format, parms);
+		buffer[WRITE_LOG_BUF_SIZE - 1] = 0;
+		EnterCriticalSection (&log_cs);
+		_tprintf (_T("%s"), buffer);
+		LeaveCriticalSection (&log_cs);
+	}
+	va_end (parms);
+}
+
+void gui_message (const TCHAR *format, ...)
+{
+}
+
+uae_u32 uaerand (void)
+{
+	return rand ();
+}
+
+/* convert time_t to/from AmigaDOS time */
+static const uae_s64 msecs_per_day = 24 * 60 * 60 * 1000;
+static const uae_s64 diff = ((8 * 365 + 2) * (24 * 60 * 60)) * (uae_u64)1000;
+
+void timeval_to_amiga (struct mytimeval *tv, int *days, int *mins, int *ticks)
+{
+	uae_s64 t = tv->tv_sec * 1000 + tv->tv_usec / 1000;
+	t -= diff;
+	if (t < 0)
+		t = 0;
+	*days = t / msecs_per_day;
+	t -= *days * msecs_per_day;
+	*mins = t / (60 * 1000);
+	t -= *mins * (60 * 1000);
+	*ticks = t / (1000 / 50);
+}
+
+void amiga_to_timeval (struct mytimeval *tv, int days, int mins, int ticks)
+{
+	uae_s64 t;
+
+	if (days < 0)
+		days = 0;
+	if (days > 9900 * 365)
+		days = 9900 * 365;
+	if (mins < 0 || mins >= 24 * 60)
+		mins = 0;
+	if (ticks < 0 || ticks >= 60 * 50)
+		ticks = 0;
+
+	t = ticks * 20;
+	t += mins * (60 * 1000);
+	t += ((uae_u64)days) * msecs_per_day;
+	t += diff;
+
+	tv->tv_sec = t / 1000;
+	tv->tv_usec = (t % 1000) * 1000;
+}
+
+#define DC_MAX_TRACKS 168
+#define DC_MAX_THREADS 64
+#define DC_SCP_SLOTS 4
+#define DC_MFM_WORDS 0x8000
+#define DC_GAP_WORDS (12668 / 2 - 11 * 544)
+
+enum { DC_UNKNOWN, DC_ADF, DC_ADFHD, DC_PC, DC_EXTADF, DC_FDI, DC_IPF, DC_SCP, DC_DATA };
+static const TCHAR *formatnames[] = {
+	_T("?"), _T("ADF"), _T("ADF-HD"), _T("PC"), _T("EXTADF"), _T("FDI"), _T("IPF"), _T("SCP"), _T("DATA")
+};
+
+struct dctrack
+{
+	uae_u8 *data;
+	int len;
+	bool sectors; /* already decoded AmigaDOS sector data */
+};
+
+struct dcimage
+{
+	uae_u8 *data;
+	int size;
+	bool pc;
+	int tracks;
+	struct dctrack track[DC_MAX_TRACKS];
+};
+
+struct dcjob
+{
+	TCHAR src[MAX_DPATH];
+	int format;
+	bool ok;
+	uae_s64 insize;
+	int outsize;
+	int tracks;
+	int badsecs;
+	int mfmerrs;
+	uae_u32 crc;
+	int ms;
+	TCHAR err[256];
+};
+
+static struct dcjob *jobs;
+static int numjobs, maxjobs;
+static volatile LONG nextjob;
+
+static CRITICAL_SECTION zfile_cs;
+static CRITICAL_SECTION scp_cs[DC_SCP_SLOTS];
+
+static TCHAR *outdir;
+static int writeext, mfmcheck, recursive;
+static LARGE_INTEGER qpf;
+
+static uae_s64 gettime (void)
+{
+	LARGE_INTEGER t;
+	QueryPerformanceCounter (&t);
+	return t.QuadPart;
+}
+
+static int elapsedms (uae_s64 start)
+{
+	return (int)((gettime () - start) * 1000 / qpf.QuadPart);
+}
+
+static void seterr (struct dcjob *j, const TCHAR *s)
+{
+	if (!j->err[0])
+		_tcsncpy (j->err, s, sizeof j->err / sizeof (TCHAR) - 1);
+}
+
+/* MFM words to big endian bytes, same layout as zfile's raw disk cache */
+static void storetrack (struct dcimage *img, int tr, uae_u16 *mfm, int bits)
+{
+	struct dctrack *t = &img->track[tr];
+	int len = bits / 8;
+	uae_u8 *p;
+
+	if (len > DC_MFM_WORDS * 2)
+		len = DC_MFM_WORDS * 2;
+	t->data = p = xmalloc (uae_u8, len + 1);
+	t->len = len;
+	for (int i = 0; i < len / 2; i++) {
+		uae_u16 v = mfm[i];
+		*p++ = v >> 8;
+		*p++ = (uae_u8)v;
+	}
+	if (img->tracks <= tr)
+		img->tracks = tr + 1;
+}
+
+static int loadfdi (struct zfile *zf, struct dcimage *img, uae_u16 *mfm)
+{
+	FDI *fdi = fdi2raw_header (zf);
+	int tracks;
+
+	if (!fdi)
+		return 0;
+	tracks = fdi2raw_get_last_track (fdi);
+	for (int i = 0; i < tracks && i < DC_MAX_TRACKS; i++) {
+		int len = 0;
+		fdi2raw_loadtrack (fdi, mfm, NULL, i, &len, NULL, NULL, 1);
+		storetrack (img, i, mfm, len);
+	}
+	fdi2raw_header_free (fdi);
+	return 1;
+}
+
+#ifdef CAPS
+static int loadipf (struct zfile *zf, struct dcimage *img, uae_u16 *mfm)
+{
+	int tracks;
+
+	if (!caps_loadimage (zf, 0, &tracks))
+		return 0;
+	for (int i = 0; i < tracks && i < DC_MAX_TRACKS; i++) {
+		int len = 0, mrev, gapo;
+		caps_loadtrack (mfm, NULL, 0, i, &len, &mrev, &gapo, NULL, true);
+		storetrack (img, i, mfm, len);
+	}
+	caps_unloadimage (0);
+	return 1;
+}
+#endif
+
+static int loadscp (struct zfile *zf, struct dcimage *img, uae_u16 *mfm, int slot)
+{
+	uae_u16 *timing;
+	int tracks;
+
+	if (!scp_open (zf, slot, &tracks))
+		return 0;
+	timing = xcalloc (uae_u16, DC_MFM_WORDS);
+	for (int i = 0; i < tracks && i < DC_MAX_TRACKS; i++) {
+		int len = 0, mrev, gapo, nextrev;
+		if (scp_loadtrack (mfm, timing, slot, i, &len, &mrev, &gapo, &nextrev, true))
+			storetrack (img, i, mfm, len);
+	}
+	scp_close (slot);
+	xfree (timing);
+	return 1;
+}
+
+static int loadextadf (struct dcimage *img, const uae_u8 *b, int size)
+{
+	int offs, tracks;
+
+	if (!memcmp (b, "UAE-1ADF", 8)) {
+		tracks = (b[10] << 8) | b[11];
+		offs = 12 + tracks * 12;
+		if (offs > size)
+			return 0;
+		for (int i = 0; i < tracks && i < DC_MAX_TRACKS; i++) {
+			const uae_u8 *h = b + 12 + i * 12;
+			struct dctrack *t = &img->track[i];
+			int len = (h[5] << 16) | (h[6] << 8) | h[7];
+			int bitlen = (h[9] << 16) | (h[10] << 8) | h[11];
+			if (offs + len > size)
+				return 0;
+			t->sectors = h[3] == 0;
+			t->len = t->sectors ? len : (bitlen + 7) / 8;
+			if (t->len > len)
+				t->len = len;
+			if (t->len > DC_MFM_WORDS * 2)
+				t->len = DC_MFM_WORDS * 2;
+			t->data = xmalloc (uae_u8, t->len + 1);
+			memcpy (t->data, b + offs, t->len);
+			img->tracks = i + 1;
+			offs += len;
+		}
+	} else {
+		/* UAE--ADF: sync word and length per track, raw tracks omit the sync */
+		tracks = 160;
+		offs = 8 + tracks * 4;
+		if (offs > size)
+			return 0;
+		for (int i = 0; i < tracks; i++) {
+			const uae_u8 *h = b + 8 + i * 4;
+			struct dctrack *t = &img->track[i];
+			int sync = (h[0] << 8) | h[1];
+			int len = (h[2] << 8) | h[3];
+			if (offs + len > size)
+				return 0;
+			t->sectors = sync == 0;
+			if (!t->sectors && len > DC_MFM_WORDS * 2 - 2)
+				return 0;
+			t->len = t->sectors ? len : len + 2;
+			t->data = xmalloc (uae_u8, t->len + 1);
+			if (t->sectors) {
+				memcpy (t->data, b + offs, len);
+			} else {
+				t->data[0] = sync >> 8;
+				t->data[1] = (uae_u8)sync;
+				memcpy (t->data + 2, b + offs, len);
+			}
+			img->tracks = i + 1;
+			offs += len;
+		}
+	}
+	return 1;
+}
+
+static int sectorformat (const uae_u8 *b, int size)
+{
+	if (size == 80 * 2 * 11 * 512 || size == 82 * 2 * 11 * 512 || size == 84 * 2 * 11 * 512)
+		return DC_ADF;
+	if (size == 80 * 2 * 22 * 512)
+		return DC_ADFHD;
+	if (size == 40 * 2 * 9 * 512 || size == 80 * 2 * 9 * 512 || size == 80 * 2 * 18 * 512)
+		return DC_PC;
+	if (size > 4 && !memcmp (b, "DOS", 3))
+		return DC_ADF;
+	return DC_DATA;
+}
+
+static int sectorspertrack (int format, int size)
+{
+	if (format == DC_PC)
+		return size == 80 * 2 * 18 * 512 ? 18 : 9;
+	if (format == DC_ADFHD)
+		return 22;
+	return 11;
+}
+
+/* unpack and read the whole image, raw formats are loaded as MFM tracks */
+static int loadimage (struct dcjob *j, struct dcimage *img, int id, uae_u16 *mfm)
+{
+	struct zfile *zf;
+	uae_u8 header[8] = { 0 };
+	int ret = 0;
+
+	EnterCriticalSection (&zfile_cs);
+	zf = zfile_fopen (j->src, _T("rb"), ZFD_NORMAL);
+	if (!zf) {
+		TCHAR *err = zfile_geterror ();
+		seterr (j, err ? err : _T("couldn't open"));
+		LeaveCriticalSection (&zfile_cs);
+		return 0;
+	}
+	zfile_fread (header, sizeof header, 1, zf);
+	zfile_fseek (zf, 0, SEEK_SET);
+	if (!memcmp (header, "CAPS", 4)) {
+		j->format = DC_IPF;
+#ifdef CAPS
+		ret = loadipf (zf, img, mfm);
+#endif
+	} else if (!memcmp (header, "Formatte", 8)) {
+		j->format = DC_FDI;
+		ret = loadfdi (zf, img, mfm);
+	} else if (!memcmp (header, "SCP", 3)) {
+		int slot = id % DC_SCP_SLOTS;
+		j->format = DC_SCP;
+		LeaveCriticalSection (&zfile_cs);
+		EnterCriticalSection (&scp_cs[slot]);
+		ret = loadscp (zf, img, mfm, slot);
+		LeaveCriticalSection (&scp_cs[slot]);
+		EnterCriticalSection (&zfile_cs);
+	} else {
+		int size = (int)zfile_size (zf);
+		uae_u8 *b = xmalloc (uae_u8, size + 1);
+		if (zfile_fread (b, 1, size, zf) == (size_t)size) {
+			if (size > 12 && (!memcmp (header, "UAE-1ADF", 8) || !memcmp (header, "UAE--ADF", 8))) {
+				j->format = DC_EXTADF;
+				ret = loadextadf (img, b, size);
+				xfree (b);
+			} else {
+				j->format = sectorformat (b, size);
+				img->data = b;
+				img->size = size;
+				img->pc = j->format == DC_PC;
+				ret = 1;
+			}
+		} else {
+			xfree (b);
+		}
+	}
+	zfile_fclose (zf);
+	LeaveCriticalSection (&zfile_cs);
+	if (!ret)
+		seterr (j, _T("unsupported or corrupt image"));
+	return ret;
+}
+
+static void freeimage (struct dcimage *img)
+{
+	for (int i = 0; i < img->tracks; i++)
+		xfree (img->track[i].data);
+	xfree (img->data);
+}
+
+static int okcount (const uae_u8 *writebuffer_ok, int secs)
+{
+	int cnt = 0;
+	for (int i = 0; i < secs; i++) {
+		if (writebuffer_ok[i])
+			cnt++;
+	}
+	return cnt;
+}
+
+/* decode MFM tracks to sector data, unreadable sectors are left zeroed */
+static void decodetracks (struct dcjob *j, struct dcimage *img, uae_u16 *amigamfmbuffer)
+{
+	uae_u8 writebuffer_ok[32];
+	int pos = 0, first = -1;
+
+	for (int i = 0; i < img->tracks; i++) {
+		if (img->track[i].data && !img->track[i].sectors) {
+			first = i;
+			break;
+		}
+	}
+	if (first >= 0) {
+		uae_u8 tmp[22 * 512];
+		int outsize;
+		struct dctrack *t = &img->track[first];
+		/* PC tracks use the same 0x4489 sync, so look for decodable sectors */
+		memset (writebuffer_ok, 0, sizeof writebuffer_ok);
+		isamigatrack (amigamfmbuffer, t->data, t->len, tmp, writebuffer_ok, first, &outsize);
+		if (!okcount (writebuffer_ok, 11)) {
+			memset (writebuffer_ok, 0, sizeof writebuffer_ok);
+			ispctrack (amigamfmbuffer, t->data, t->len, tmp, writebuffer_ok, first, &outsize);
+			img->pc = okcount (writebuffer_ok, outsize / 512) > 0;
+		}
+	}
+
+	img->data = xcalloc (uae_u8, img->tracks * 22 * 512 + 1);
+	for (int i = 0; i < img->tracks; i++) {
+		struct dctrack *t = &img->track[i];
+		int outsize = img->pc ? 9 * 512 : 11 * 512;
+		int secs;
+
+		memset (writebuffer_ok, 0, sizeof writebuffer_ok);
+		if (!t->data) {
+			;
+		} else if (t->sectors) {
+			outsize = t->len > 22 * 512 ? 22 * 512 : t->len;
+			memcpy (img->data + pos, t->data, outsize);
+			memset (writebuffer_ok, 0xff, sizeof writebuffer_ok);
+		} else if (img->pc) {
+			ispctrack (amigamfmbuffer, t->data, t->len, img->data + pos, writebuffer_ok, i, &outsize);
+		} else {
+			isamigatrack (amigamfmbuffer, t->data, t->len, img->data + pos, writebuffer_ok, i, &outsize);
+		}
+		secs = outsize / 512;
+		j->badsecs += secs - okcount (writebuffer_ok, secs);
+		pos += outsize;
+	}
+	img->size = pos;
+}
+
+static void mfmcode (uae_u16 *mfm, int words)
+{
+	uae_u32 lastword = 0;
+	while (words--) {
+		uae_u32 v = (*mfm) & 0x55555555;
+		uae_u32 lv = (lastword << 16) | v;
+		uae_u32 nlv = 0x55555555 & ~lv;
+		uae_u32 mfmbits = (nlv << 1) & (nlv >> 1);
+		*mfm++ = v | mfmbits;
+		lastword = v;
+	}
+}
+
+/* AmigaDOS track encoder, same layout as disk.cpp without the index wrap */
+static int encodetrack (uae_u16 *dst, const uae_u8 *data, int tr, int secs)
+{
+	int len = DC_GAP_WORDS;
+	int prevbit = 0;
+
+	for (int i = 0; i < len; i++)
+		dst[i] = 0xaaaa;
+	for (int sec = 0; sec < secs; sec++) {
+		uae_u8 secbuf[544];
+		uae_u16 mfmbuf[544 + 1];
+		uae_u32 deven, dodd;
+		uae_u32 hck = 0, dck = 0;
+		int i;
+
+		secbuf[0] = secbuf[1] = 0x00;
+		secbuf[2] = secbuf[3] = 0xa1;
+		secbuf[4] = 0xff;
+		secbuf[5] = tr;
+		secbuf[6] = sec;
+		secbuf[7] = secs - sec;
+		for (i = 8; i < 24; i++)
+			secbuf[i] = 0;
+		memcpy (&secbuf[32], data + sec * 512, 512);
+
+		mfmbuf[0] = prevbit ? 0x2aaa : 0xaaaa;
+		mfmbuf[1] = 0xaaaa;
+		mfmbuf[2] = mfmbuf[3] = 0x4489;
+
+		deven = ((secbuf[4] << 24) | (secbuf[5] << 16) | (secbuf[6] << 8) | (secbuf[7]));
+		dodd = deven >> 1;
+		deven &= 0x55555555;
+		dodd &= 0x55555555;
+		mfmbuf[4] = dodd >> 16;
+		mfmbuf[5] = dodd;
+		mfmbuf[6] = deven >> 16;
+		mfmbuf[7] = deven;
+
+		for (i = 8; i < 48; i++)
+			mfmbuf[i] = 0xaaaa;
+		for (i = 0; i < 512; i += 4) {
+			deven = ((secbuf[i + 32] << 24) | (secbuf[i + 33] << 16) | (secbuf[i + 34] << 8) | (secbuf[i + 35]));
+			dodd = deven >> 1;
+			deven &= 0x55555555;
+			dodd &= 0x55555555;
+			mfmbuf[(i >> 1) + 32] = dodd >> 16;
+			mfmbuf[(i >> 1) + 33] = dodd;
+			mfmbuf[(i >> 1) + 256 + 32] = deven >> 16;
+			mfmbuf[(i >> 1) + 256 + 33] = deven;
+		}
+
+		for (i = 4; i < 24; i += 2)
+			hck ^= (mfmbuf[i] << 16) | mfmbuf[i + 1];
+		deven = dodd = hck;
+		dodd >>= 1;
+		mfmbuf[24] = dodd >> 16;
+		mfmbuf[25] = dodd;
+		mfmbuf[26] = deven >> 16;
+		mfmbuf[27] = deven;
+
+		for (i = 32; i < 544; i += 2)
+			dck ^= (mfmbuf[i] << 16) | mfmbuf[i + 1];
+		deven = dodd = dck;
+		dodd >>= 1;
+		mfmbuf[28] = dodd >> 16;
+		mfmbuf[29] = dodd;
+		mfmbuf[30] = deven >> 16;
+		mfmbuf[31] = deven;
+
+		mfmbuf[544] = 0;
+		mfmcode (mfmbuf + 4, 544 - 4 + 1);
+		memcpy (dst + len, mfmbuf, 544 * 2);
+		len += 544;
+		prevbit = mfmbuf[543] & 1;
+	}
+	return len;
+}
+
+static void tobytes (uae_u8 *dst, const uae_u16 *mfm, int words)
+{
+	for (int i = 0; i < words; i++) {
+		*dst++ = mfm[i] >> 8;
+		*dst++ = (uae_u8)mfm[i];
+	}
+}
+
+/* encode every track and decode it back, counts tracks that don't survive */
+static void mfmverify (struct dcjob *j, struct dcimage *img, uae_u16 *mfm, uae_u16 *amigamfmbuffer)
+{
+	uae_u8 *raw = xmalloc (uae_u8, DC_MFM_WORDS * 2);
+	int tracks = img->size / (11 * 512);
+
+	for (int i = 0; i < tracks; i++) {
+		uae_u8 out[11 * 512];
+		uae_u8 writebuffer_ok[32];
+		const uae_u8 *src = img->data + i * 11 * 512;
+		int words = encodetrack (mfm, src, i, 11);
+		int outsize;
+
+		tobytes (raw, mfm, words);
+		memset (writebuffer_ok, 0, sizeof writebuffer_ok);
+		if (isamigatrack (amigamfmbuffer, raw, words * 2, out, writebuffer_ok, i, &outsize) || memcmp (out, src, sizeof out))
+			j->mfmerrs++;
+	}
+	xfree (raw);
+}
+
+static void outname (TCHAR *dst, const TCHAR *src, const TCHAR *ext)
+{
+	const TCHAR *name = _tcsrchr (src, '\\');
+	TCHAR *p;
+
+	name = name ? name + 1 : src;
+	_stprintf (dst, _T("%s\\%s"), outdir, name);
+	p = _tcsrchr (dst, '.');
+	if (p && !_tcschr (p, '\\'))
+		*p = 0;
+	_tcscat (dst, ext);
+}
+
+static int writeimage (struct dcjob *j, struct dcimage *img, uae_u16 *mfm)
+{
+	TCHAR path[MAX_DPATH];
+	FILE *f;
+	int ok;
+
+	if (writeext && !img->pc && (img->size % (11 * 512)) == 0) {
+		int tracks = img->size / (11 * 512);
+		uae_u8 *raw = xmalloc (uae_u8, DC_MFM_WORDS * 2);
+		uae_u8 tmp[12];
+
+		outname (path, j->src, _T(".ext.adf"));
+		f = _tfopen (path, _T("wb"));
+		if (!f) {
+			xfree (raw);
+			seterr (j, _T("couldn't create output file"));
+			return 0;
+		}
+		ok = fwrite ("UAE-1ADF", 8, 1, f) == 1;
+		tmp[0] = tmp[1] = 0;
+		tmp[2] = tracks >> 8;
+		tmp[3] = tracks;
+		fwrite (tmp, 4, 1, f);
+		for (int i = 0; i < tracks; i++) {
+			int len = (DC_GAP_WORDS + 11 * 544) * 2;
+			int bits = len * 8;
+			memset (tmp, 0, sizeof tmp);
+			tmp[3] = 1;
+			tmp[5] = len >> 16; tmp[6] = len >> 8; tmp[7] = len;
+			tmp[9] = bits >> 16; tmp[10] = bits >> 8; tmp[11] = bits;
+			fwrite (tmp, sizeof tmp, 1, f);
+		}
+		for (int i = 0; i < tracks && ok; i++) {
+			int words = encodetrack (mfm, img->data + i * 11 * 512, i, 11);
+			tobytes (raw, mfm, words);
+			ok = fwrite (raw, words * 2, 1, f) == 1;
+		}
+		xfree (raw);
+	} else {
+		outname (path, j->src, img->pc ? _T(".ima") : _T(".adf"));
+		f = _tfopen (path, _T("wb"));
+		if (!f) {
+			seterr (j, _T("couldn't create output file"));
+			return 0;
+		}
+		ok = fwrite (img->data, img->size, 1, f) == 1;
+	}
+	if (fclose (f))
+		ok = 0;
+	if (!ok)
+		seterr (j, _T("write error"));
+	return ok;
+}
+
+static void processjob (struct dcjob *j, int id, uae_u16 *mfm, uae_u16 *amigamfmbuffer)
+{
+	struct dcimage *img = xcalloc (struct dcimage, 1);
+	WIN32_FILE_ATTRIBUTE_DATA fad;
+	uae_s64 start = gettime ();
+
+	if (GetFileAttributesEx (j->src, GetFileExInfoStandard, &fad))
+		j->insize = ((uae_s64)fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+	if (!loadimage (j, img, id, mfm))
+		goto end;
+	if (img->tracks) {
+		decodetracks (j, img, amigamfmbuffer);
+		j->tracks = img->tracks;
+	} else {
+		j->tracks = img->size / (sectorspertrack (j->format, img->size) * 512);
+	}
+	j->outsize = img->size;
+	j->crc = get_crc32 (img->data, img->size);
+	if (mfmcheck && !img->pc && j->format != DC_ADFHD && j->format != DC_DATA)
+		mfmverify (j, img, mfm, amigamfmbuffer);
+	if (outdir && !writeimage (j, img, mfm))
+		goto end;
+	j->ok = j->badsecs == 0 && j->mfmerrs == 0;
+	if (!j->ok)
+		seterr (j, j->badsecs ? _T("unreadable sectors") : _T("MFM round trip failed"));
+end:
+	freeimage (img);
+	xfree (img);
+	j->ms = elapsedms (start);
+}
+
+static DWORD WINAPI worker (LPVOID arg)
+{
+	int id = (int)(INT_PTR)arg;
+	uae_u16 *mfm = xcalloc (uae_u16, DC_MFM_WORDS);
+	uae_u16 *amigamfmbuffer = xcalloc (uae_u16, DC_MFM_WORDS);
+
+	for (;;) {
+		LONG n = InterlockedIncrement (&nextjob) - 1;
+		if (n >= numjobs)
+			break;
+		processjob (&jobs[n], id, mfm, amigamfmbuffer);
+	}
+	xfree (amigamfmbuffer);
+	xfree (mfm);
+	return 0;
+}
+
+static const TCHAR *exts[] = {
+	_T("adf"), _T("adz"), _T("dms"), _T("ipf"), _T("fdi"), _T("scp"), _T("ima"),
+	_T("zip"), _T("lha"), _T("lzh"), _T("7z"), _T("rar"), _T("gz"), _T("xz"), NULL
+};
+
+static int knownext (const TCHAR *name)
+{
+	const TCHAR *ext = _tcsrchr (name, '.');
+	if (!ext)
+		return 0;
+	for (int i = 0; exts[i]; i++) {
+		if (!_tcsicmp (ext + 1, exts[i]))
+			return 1;
+	}
+	return 0;
+}
+
+static void addjob (const TCHAR *path)
+{
+	if (numjobs >= maxjobs) {
+		maxjobs = maxjobs ? maxjobs * 2 : 256;
+		jobs = xrealloc (struct dcjob, jobs, maxjobs);
+	}
+	memset (&jobs[numjobs], 0, sizeof (struct dcjob));
+	GetFullPathName (path, MAX_DPATH, jobs[numjobs].src, NULL);
+	numjobs++;
+}
+
+static void scanpath (const TCHAR *src, int level)
+{
+	WIN32_FIND_DATA ffd;
+	HANDLE h;
+	TCHAR path[MAX_DPATH], dir[MAX_DPATH];
+	DWORD attr = GetFileAttributes (src);
+	TCHAR *p;
+
+	if (attr != INVALID_FILE_ATTRIBUTES && !(attr & FILE_ATTRIBUTE_DIRECTORY)) {
+		addjob (src);
+		return;
+	}
+	if (attr != INVALID_FILE_ATTRIBUTES) {
+		_tcscpy (dir, src);
+		_stprintf (path, _T("%s\\*.*"), src);
+	} else {
+		/* wildcard pattern */
+		_tcscpy (path, src);
+		_tcscpy (dir, src);
+		p = _tcsrchr (dir, '\\');
+		if (p)
+			*p = 0;
+		else
+			_tcscpy (dir, _T("."));
+	}
+	h = FindFirstFile (path, &ffd);
+	if (h == INVALID_HANDLE_VALUE) {
+		if (!level)
+			_tprintf (_T("'%s' not found\n"), src);
+		return;
+	}
+	for (;;) {
+		_stprintf (path, _T("%s\\%s"), dir, ffd.cFileName);
+		if (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			if (recursive && _tcscmp (ffd.cFileName, _T(".")) && _tcscmp (ffd.cFileName, _T("..")))
+				scanpath (path, level + 1);
+		} else if (knownext (ffd.cFileName)) {
+			addjob (path);
+		}
+		if (!FindNextFile (h, &ffd))
+			break;
+	}
+	FindClose (h);
+}
+
+static void report (int ms)
+{
+	int good = 0;
+	uae_s64 in = 0, out = 0;
+	double secs = ms > 0 ? ms / 1000.0 : 0.001;
+
+	_tprintf (_T("Result Format  Trk  Bad  MFM CRC32       Size     Time Name\n"));
+	for (int i = 0; i < numjobs; i++) {
+		struct dcjob *j = &jobs[i];
+		_tprintf (_T("%-6s %-6s %3d %4d %4d %08X %8d %6dms %s%s%s\n"),
+			j->ok ? _T("OK") : _T("FAIL"), formatnames[j->format], j->tracks, j->badsecs, j->mfmerrs,
+			j->crc, j->outsize, j->ms, j->src, j->err[0] ? _T(": ") : _T(""), j->err);
+		if (j->ok)
+			good++;
+		in += j->insize;
+		out += j->outsize;
+	}
+	_tprintf (_T("\n%d images, %d ok, %d failed in %d.%03d seconds\n"),
+		numjobs, good, numjobs - good, ms / 1000, ms % 1000);
+	_tprintf (_T("%.1f images/s, %.2f MB/s read, %.2f MB/s decoded\n"),
+		numjobs / secs, in / secs / (1024 * 1024), out / secs / (1024 * 1024));
+}
+
+int __cdecl wmain (int argc, wchar_t *argv[], wchar_t *envp[])
+{
+	HANDLE threads[DC_MAX_THREADS];
+	SYSTEM_INFO si;
+	int numthreads = 0;
+	uae_s64 start;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!_tcsicmp (argv[i], _T("-o")) && i + 1 < argc) {
+			outdir = argv[++i];
+		} else if (!_tcsicmp (argv[i], _T("-t")) && i + 1 < argc) {
+			numthreads = _tstol (argv[++i]);
+		} else if (!_tcsicmp (argv[i], _T("-x"))) {
+			writeext = 1;
+		} else if (!_tcsicmp (argv[i], _T("-m"))) {
+			mfmcheck = 1;
+		} else if (!_tcsicmp (argv[i], _T("-r"))) {
+			recursive = 1;
+		} else if (!_tcsicmp (argv[i], _T("-v"))) {
+			verbose = 1;
+		} else {
+			scanpath (argv[i], 0);
+		}
+	}
+	if (!numjobs) {
+		_tprintf (_T("UAE floppy image converter uaediskconv 0.1\n"));
+		_tprintf (_T("\n"));
+		_tprintf (_T("Verify: \"uaediskconv [-m] [-r] [-t <threads>] <files or directories>\"\n"));
+		_tprintf (_T("Convert: \"uaediskconv -o <output directory> [-x] <files or directories>\"\n"));
+		_tprintf (_T("\n"));
+		_tprintf (_T(" -m  encode sector data to MFM and decode it back\n"));
+		_tprintf (_T(" -x  write extended ADF (MFM tracks) instead of ADF\n"));
+		_tprintf (_T(" -r  scan directories recursively\n"));
+		_tprintf (_T(" -t  number of worker threads, default is one per CPU\n"));
+		_tprintf (_T(" -v  show decoder log\n"));
+		_tprintf (_T("\n"));
+		_tprintf (_T("Supported disk image formats:\n"));
+		_tprintf (_T(" ADF, extended ADF, PC, DMS, IPF, FDI, SCP\n"));
+		_tprintf (_T("Supported archive formats:\n"));
+		_tprintf (_T(" 7ZIP, LHA, LZX, RAR (unrar.dll), ZIP, GZIP, XZ\n"));
+		return 0;
+	}
+
+	if (numthreads <= 0) {
+		GetSystemInfo (&si);
+		numthreads = si.dwNumberOfProcessors;
+	}
+	if (numthreads > DC_MAX_THREADS)
+		numthreads = DC_MAX_THREADS;
+	if (numthreads > numjobs)
+		numthreads = numjobs;
+
+	InitializeCriticalSection (&log_cs);
+	InitializeCriticalSection (&zfile_cs);
+	for (i = 0; i < DC_SCP_SLOTS; i++)
+		InitializeCriticalSection (&scp_cs[i]);
+	QueryPerformanceFrequency (&qpf);
+
+	start = gettime ();
+	for (i = 0; i < numthreads; i++)
+		threads[i] = CreateThread (NULL, 0, worker, (LPVOID)(INT_PTR)i, 0, NULL);
+	for (i = 0; i < numthreads; i++) {
+		if (threads[i]) {
+			WaitForSingleObject (threads[i], INFINITE);
+			CloseHandle (threads[i]);
+		}
+	}
+	/* pick up whatever is left if threads couldn't be created */
+	worker (0);
+	report (elapsedms (start));
+
+	for (i = 0; i < DC_SCP_SLOTS; i++)
+		DeleteCriticalSection (&scp_cs[i]);
+	DeleteCriticalSection (&zfile_cs);
+	DeleteCriticalSection (&log_cs);
+	xfree (jobs);
+	return 0;
+}
@@ -28,6 +28,13 @@
 #include "archivers/dms/pfile.h"
 #include "archivers/wrp/warp.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
 static struct zfile *zlist = 0;
 
 const TCHAR *uae_archive_extensions[] = { _T("zip"), _T("rar"), _T("7z"), _T("lha"), _T("lzh"), _T("lzx"), _T("tar"), NULL };
@@ -175,8 +182,53 @@ static struct zfile *zfile_create (struct zfile *prev, const TCHAR *originalname
 	return z;
 }
 
+/* Large read-only physical files are mapped instead of going through
+* stdio. Anything writable, text mode or unmappable keeps using FILE*.  */
+#define ZFILE_MAP_MIN (1024 * 1024)
+#define ZFILE_MAP_MAX_32BIT (256 * 1024 * 1024)
+
+static void zfile_map (struct zfile *z)
+{
+	if (!z->f || z->mapped || z->textmode || !z->mode || _tcscmp (z->mode, _T("rb")))
+		return;
+	if (z->size < ZFILE_MAP_MIN)
+		return;
+	if (sizeof (void*) < 8 && z->size > ZFILE_MAP_MAX_32BIT)
+		return;
+#ifdef _WIN32
+	HANDLE h = (HANDLE)_get_osfhandle (_fileno (z->f));
+	if (h == INVALID_HANDLE_VALUE)
+		return;
+	HANDLE m = CreateFileMapping (h, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m)
+		return;
+	/* the view keeps the mapping object alive */
+	z->mapped = (uae_u8*)MapViewOfFile (m, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle (m);
+#else
+	void *p = mmap (NULL, z->size, PROT_READ, MAP_PRIVATE, fileno (z->f), 0);
+	z->mapped = p == MAP_FAILED ? NULL : (uae_u8*)p;
+#endif
+	if (z->mapped)
+		z->mappedsize = z->size;
+}
+
+static void zfile_unmap (struct zfile *z)
+{
+	if (!z->mapped)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile (z->mapped);
+#else
+	munmap (z->mapped, z->mappedsize);
+#endif
+	z->mapped = NULL;
+	z->mappedsize = 0;
+}
+
 static void zfile_free (struct zfile *f)
 {
+	zfile_unmap (f);
 	if (f->f)
 		fclose (f->f);
 	if (f->deleteafterclose) {
@@ -187,6 +239,8 @@ static void zfile_free (struct zfile *f)
 	xfree (f->originalname);
 	xfree (f->data);
 	xfree (f->mode);
+	if (f->zfileclose)
+		f->zfileclose (f);
 	xfree (f->userdata);
 	xfree (f);
 }
@@ -534,6 +588,370 @@ end:
 	return z;
 }
 
+/* Seekable inflate. Large deflate streams (gzip files, zip entries) are
+ * not unpacked into memory. Restart points (bit position plus the 32K
+ * history window) are recorded every ZSTREAM_SPAN bytes while inflating
+ * forward, later reads restart from the nearest point. Decompressed data
+ * is kept in a small LRU cache of ZSTREAM_CHUNK sized chunks. */
+#define ZSTREAM_SPAN (4 * 1024 * 1024)
+#define ZSTREAM_WINSIZE 32768
+#define ZSTREAM_CHUNK (256 * 1024)
+#define ZSTREAM_CHUNKS 32
+#define ZSTREAM_INBUF 65536
+
+struct zstream_point
+{
+	uae_s64 out; // uncompressed offset
+	uae_s64 in; // compressed offset of first complete byte
+	int bits; // unused bits in byte in - 1
+	uae_u8 window[ZSTREAM_WINSIZE];
+};
+
+struct zstream_chunk
+{
+	uae_s64 pos;
+	int len;
+	unsigned int stamp;
+	uae_u8 *data;
+};
+
+struct zfile_stream
+{
+	uae_s64 packedsize;
+	struct zstream_point **points;
+	int numpoints, maxpoints;
+	z_stream zs;
+	int active, eof;
+	uae_s64 in, out;
+	int winpos;
+	uae_u8 window[ZSTREAM_WINSIZE];
+	uae_u8 inbuf[ZSTREAM_INBUF];
+	struct zstream_chunk chunks[ZSTREAM_CHUNKS];
+	unsigned int stamp;
+	int hits, misses, restarts;
+};
+
+static void zstream_addpoint (struct zfile_stream *zs)
+{
+	struct zstream_point *p;
+
+	if (zs->numpoints == zs->maxpoints) {
+		zs->maxpoints = zs->maxpoints ? zs->maxpoints * 2 : 64;
+		zs->points = xrealloc (struct zstream_point*, zs->points, zs->maxpoints);
+	}
+	p = xmalloc (struct zstream_point, 1);
+	if (!p)
+		return;
+	p->out = zs->out;
+	p->in = zs->in - zs->zs.avail_in;
+	p->bits = zs->zs.data_type & 7;
+	// oldest history byte is at winpos, window is always full past ZSTREAM_SPAN
+	memcpy (p->window, zs->window + zs->winpos, ZSTREAM_WINSIZE - zs->winpos);
+	memcpy (p->window + ZSTREAM_WINSIZE - zs->winpos, zs->window, zs->winpos);
+	zs->points[zs->numpoints++] = p;
+}
+
+static bool zstream_restart (struct zfile *zf, struct zstream_point *p)
+{
+	struct zfile_stream *zs = (struct zfile_stream*)zf->userdata;
+
+	if (zs->active)
+		inflateEnd (&zs->zs);
+	zs->active = 0;
+	zs->eof = 0;
+	memset (&zs->zs, 0, sizeof zs->zs);
+	if (inflateInit2_ (&zs->zs, -MAX_WBITS, ZLIB_VERSION, sizeof (z_stream)) != Z_OK)
+		return false;
+	zs->active = 1;
+	zs->in = 0;
+	zs->out = 0;
+	zs->winpos = 0;
+	if (p) {
+		zs->in = p->in;
+		zs->out = p->out;
+		if (p->bits) {
+			uae_u8 b;
+			zfile_fseek (zf->parent, zf->offset + p->in - 1, SEEK_SET);
+			if (zfile_fread (&b, 1, 1, zf->parent) != 1)
+				return false;
+			inflatePrime (&zs->zs, p->bits, b >> (8 - p->bits));
+		}
+		inflateSetDictionary (&zs->zs, p->window, ZSTREAM_WINSIZE);
+		memcpy (zs->window, p->window, ZSTREAM_WINSIZE);
+	}
+	zs->restarts++;
+	return true;
+}
+
+/* inflate len bytes to dst (NULL = skip), returns bytes produced */
+static int zstream_inflate (struct zfile *zf, uae_u8 *dst, int len)
+{
+	struct zfile_stream *zs = (struct zfile_stream*)zf->userdata;
+	int total = 0;
+
+	while (len > 0 && !zs->eof) {
+		int avail, n, ret;
+		if (zs->zs.avail_in == 0) {
+			uae_s64 left = zs->packedsize - zs->in;
+			if (left > ZSTREAM_INBUF)
+				left = ZSTREAM_INBUF;
+			if (left > 0) {
+				zfile_fseek (zf->parent, zf->offset + zs->in, SEEK_SET);
+				left = zfile_fread (zs->inbuf, 1, (size_t)left, zf->parent);
+			}
+			// raw inflate may want one byte past the end, give it a zero
+			if (left <= 0) {
+				if (zs->in > zs->packedsize) {
+					zs->eof = 1;
+					break;
+				}
+				zs->inbuf[0] = 0;
+				left = 1;
+			}
+			zs->zs.next_in = zs->inbuf;
+			zs->zs.avail_in = (uInt)left;
+			zs->in += left;
+		}
+		if (zs->winpos == ZSTREAM_WINSIZE)
+			zs->winpos = 0;
+		avail = ZSTREAM_WINSIZE - zs->winpos;
+		if (avail > len)
+			avail = len;
+		zs->zs.next_out = zs->window + zs->winpos;
+		zs->zs.avail_out = avail;
+		ret = inflate (&zs->zs, Z_BLOCK);
+		n = avail - zs->zs.avail_out;
+		if (dst) {
+			memcpy (dst, zs->window + zs->winpos, n);
+			dst += n;
+		}
+		zs->winpos += n;
+		zs->out += n;
+		total += n;
+		len -= n;
+		if (ret == Z_STREAM_END || (ret != Z_OK && ret != Z_BUF_ERROR) || (ret == Z_BUF_ERROR && !n)) {
+			if (ret != Z_STREAM_END)
+				write_log (_T("ZSTREAM: '%s' inflate error %d at %lld\n"), zf->name, ret, zs->out);
+			zs->eof = 1;
+			break;
+		}
+		// end of deflate block, not last block: possible restart point
+		if ((zs->zs.data_type & 128) && !(zs->zs.data_type & 64)) {
+			uae_s64 last = zs->numpoints ? zs->points[zs->numpoints - 1]->out : 0;
+			if (zs->out - last >= ZSTREAM_SPAN)
+				zstream_addpoint (zs);
+		}
+	}
+	return total;
+}
+
+static struct zstream_chunk *zstream_newchunk (struct zfile_stream *zs)
+{
+	struct zstream_chunk *c = &zs->chunks[0];
+	for (int i = 1; i < ZSTREAM_CHUNKS; i++) {
+		if (zs->chunks[i].stamp < c->stamp)
+			c = &zs->chunks[i];
+	}
+	if (!c->data) {
+		c->data = xmalloc (uae_u8, ZSTREAM_CHUNK);
+		if (!c->data)
+			return NULL;
+	}
+	c->pos = -1;
+	c->len = 0;
+	c->stamp = ++zs->stamp;
+	return c;
+}
+
+static struct zstream_chunk *zstream_getchunk (struct zfile *zf, uae_s64 pos)
+{
+	struct zfile_stream *zs = (struct zfile_stream*)zf->userdata;
+	struct zstream_point *p = NULL;
+	struct zstream_chunk *c;
+	int lo, hi;
+
+	for (int i = 0; i < ZSTREAM_CHUNKS; i++) {
+		c = &zs->chunks[i];
+		if (c->pos == pos && c->data) {
+			c->stamp = ++zs->stamp;
+			zs->hits++;
+			return c;
+		}
+	}
+	zs->misses++;
+	// last restart point at or before pos
+	lo = 0;
+	hi = zs->numpoints;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (zs->points[mid]->out <= pos)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo > 0)
+		p = zs->points[lo - 1];
+	// continue the live stream if it is between the point and pos
+	if (!zs->active || zs->eof || zs->out > pos || zs->out < (p ? p->out : 0)) {
+		if (!zstream_restart (zf, p))
+			return NULL;
+	}
+	while (zs->out < pos) {
+		uae_s64 skip = pos - zs->out;
+		// chunks passed on the way are cached too, helps sequential readers
+		if (!(zs->out & (ZSTREAM_CHUNK - 1)) && skip >= ZSTREAM_CHUNK) {
+			c = zstream_newchunk (zs);
+			if (!c)
+				return NULL;
+			c->pos = zs->out;
+			c->len = zstream_inflate (zf, c->data, ZSTREAM_CHUNK);
+			if (c->len < ZSTREAM_CHUNK)
+				return NULL;
+			continue;
+		}
+		if (skip > ZSTREAM_CHUNK - (zs->out & (ZSTREAM_CHUNK - 1)))
+			skip = ZSTREAM_CHUNK - (zs->out & (ZSTREAM_CHUNK - 1));
+		if (zstream_inflate (zf, NULL, (int)skip) < skip)
+			return NULL;
+	}
+	c = zstream_newchunk (zs);
+	if (!c)
+		return NULL;
+	c->len = zstream_inflate (zf, c->data, ZSTREAM_CHUNK);
+	if (c->len <= 0)
+		return NULL;
+	c->pos = pos;
+	return c;
+}
+
+static uae_s64 zstream_fread (void *data, uae_u64 l1, uae_u64 l2, struct zfile *zf)
+{
+	uae_u64 size = l1 * l2;
+	uae_u64 got = 0;
+
+	if (!l1 || !l2 || zf->seek >= zf->size)
+		return 0;
+	if (zf->seek + size > zf->size)
+		size = zf->size - zf->seek;
+	while (got < size) {
+		uae_s64 pos = zf->seek & ~(uae_s64)(ZSTREAM_CHUNK - 1);
+		struct zstream_chunk *c = zstream_getchunk (zf, pos);
+		int off = (int)(zf->seek - pos);
+		uae_u64 n;
+		if (!c || off >= c->len)
+			break;
+		n = c->len - off;
+		if (n > size - got)
+			n = size - got;
+		memcpy ((uae_u8*)data + got, c->data + off, (size_t)n);
+		got += n;
+		zf->seek += n;
+	}
+	return got / l1;
+}
+
+/* Unpack the whole file into memory and turn zf into a plain data zfile,
+ * as it would have been without streaming. */
+static bool zstream_unpack (struct zfile *zf)
+{
+	uae_s64 seek = zf->seek;
+	uae_u8 *data;
+
+	data = xmalloc (uae_u8, zf->size);
+	if (!data)
+		return false;
+	zf->seek = 0;
+	if ((uae_s64)zfile_fread (data, 1, (size_t)zf->size, zf) != zf->size) {
+		write_log (_T("ZSTREAM: '%s' unpack failed\n"), zf->name);
+		xfree (data);
+		zf->seek = seek;
+		return false;
+	}
+	if (zf->zfileclose)
+		zf->zfileclose (zf);
+	xfree (zf->userdata);
+	zf->userdata = NULL;
+	zf->zfileread = NULL;
+	zf->zfilewrite = NULL;
+	zf->zfileclose = NULL;
+	zf->useparent = 0;
+	zf->offset = 0;
+	zf->data = data;
+	zf->datasize = zf->allocsize = zf->size;
+	zf->seek = seek;
+	write_log (_T("ZSTREAM: '%s' written to, unpacked %lld bytes into memory\n"), zf->name, zf->size);
+	return true;
+}
+
+static uae_s64 zstream_fwrite (const void *data, uae_u64 l1, uae_u64 l2, struct zfile *zf)
+{
+	if (!zstream_unpack (zf))
+		return 0;
+	return zfile_fwrite (data, (size_t)l1, (size_t)l2, zf);
+}
+
+static void zstream_close (struct zfile *zf)
+{
+	struct zfile_stream *zs = (struct zfile_stream*)zf->userdata;
+
+	write_log (_T("ZSTREAM: '%s' closed, %d restart points, %d/%d chunk hits, %d restarts\n"),
+		zf->name, zs->numpoints, zs->hits, zs->hits + zs->misses, zs->restarts);
+	if (zs->active)
+		inflateEnd (&zs->zs);
+	for (int i = 0; i < zs->numpoints; i++)
+		xfree (zs->points[i]);
+	xfree (zs->points);
+	for (int i = 0; i < ZSTREAM_CHUNKS; i++)
+		xfree (zs->chunks[i].data);
+}
+
+/* read-only view of raw deflate data at offset in z, decompressed on demand */
+struct zfile *zfile_fopen_inflate (struct zfile *z, const TCHAR *name, uae_s64 offset, uae_s64 packedsize, uae_s64 size)
+{
+	struct zfile_stream *zs;
+	struct zfile *l;
+	struct zstream_chunk *c;
+
+	if (size <= 0 || packedsize <= 0)
+		return NULL;
+	zs = xcalloc (struct zfile_stream, 1);
+	if (!zs)
+		return NULL;
+	l = zfile_fopen_parent (z, name, offset, size);
+	if (!l) {
+		xfree (zs);
+		return NULL;
+	}
+	l->useparent = 0;
+	l->dataseek = 1;
+	l->userdata = zs;
+	l->zfileread = zstream_fread;
+	l->zfilewrite = zstream_fwrite;
+	l->zfileclose = zstream_close;
+	zs->packedsize = packedsize;
+	for (int i = 0; i < ZSTREAM_CHUNKS; i++)
+		zs->chunks[i].pos = -1;
+	// catch garbage now rather than on the first emulated read
+	c = zstream_getchunk (l, 0);
+	if (!c || c->len < (size < ZSTREAM_CHUNK ? size : ZSTREAM_CHUNK)) {
+		zfile_fclose (l);
+		return NULL;
+	}
+	write_log (_T("ZSTREAM: '%s' %lld bytes, %lld packed, decompressing on demand\n"), l->name, size, packedsize);
+	return l;
+}
+
+/* view of stored (uncompressed) data at offset in z, copied to memory on first write */
+struct zfile *zfile_fopen_stored (struct zfile *z, const TCHAR *name, uae_s64 offset, uae_s64 size)
+{
+	struct zfile *l;
+
+	l = zfile_fopen_parent (z, name, offset, size);
+	if (l)
+		l->zfilewrite = zstream_fwrite;
+	return l;
+}
+
 static struct zfile *zfile_gunzip (struct zfile *z, int *retcode)
 {
 	uae_u8 header[2 + 1 + 1 + 4 + 1 + 1];
@@ -593,8 +1011,16 @@ static struct zfile *zfile_gunzip (struct zfile *z, int *retcode)
 	size |= b << 16;
 	zfile_fread (&b, 1, 1, z);
 	size |= b << 24;
-	if (size < 8 || size > 256 * 1024 * 1024) /* safety check */
+	if ((uae_u32)size < 8) /* safety check */
 		return NULL;
+	// ISIZE is modulo 2^32, originals over 4G are not supported
+	if ((uae_u32)size >= ZSTREAM_MIN) {
+		z2 = zfile_fopen_inflate (z, name, offset, zfile_size (z) - offset - 8, (uae_u32)size);
+		if (z2) {
+			zfile_fclose (z);
+			return z2;
+		}
+	}
 	zfile_fseek (z, offset, SEEK_SET);
 	z2 = zfile_fopen_empty (z, name, size);
 	if (!z2)
@@ -1706,6 +2132,7 @@ static struct zfile *zfile_fopen_2 (const TCHAR *name, const TCHAR *mode, int ma
 		if (my_stat (l->name, &st))
 			l->size = st.size;
 		l->f = f;
+		zfile_map (l);
 	}
 	return l;
 }
@@ -1996,7 +2423,6 @@ struct zfile *zfile_dup (struct zfile *zf)
 		nzf = zfile_create (zf, NULL);
 		nzf->f = ff;
 	}
-	zfile_fseek (nzf, zf->seek, SEEK_SET);
 	if (zf->name)
 		nzf->name = my_strdup (zf->name);
 	if (nzf->zipname)
@@ -2004,6 +2430,9 @@ struct zfile *zfile_dup (struct zfile *zf)
 	nzf->zfdmask = zf->zfdmask;
 	nzf->mode = my_strdup (zf->mode);
 	nzf->size = zf->size;
+	if (zf->mapped)
+		zfile_map (nzf);
+	zfile_fseek (nzf, zfile_ftell (zf), SEEK_SET);
 	return nzf;
 }
 
@@ -2022,7 +2451,7 @@ int zfile_exists (const TCHAR *name)
 
 int zfile_iscompressed (struct zfile *z)
 {
-	return z->data ? 1 : 0;
+	return z->data || z->zfileread == zstream_fread || z->zfilewrite == zstream_fwrite ? 1 : 0;
 }
 
 struct zfile *zfile_fopen_empty (struct zfile *prev, const TCHAR *name, uae_u64 size)
@@ -2159,7 +2588,7 @@ uae_s64 zfile_size (struct zfile *z)
 
 uae_s64 zfile_ftell (struct zfile *z)
 {
-	if (z->data || z->dataseek || z->parent)
+	if (z->data || z->dataseek || z->parent || z->mapped)
 		return z->seek;
 	return _ftelli64 (z->f);
 
@@ -2169,7 +2598,7 @@ uae_s64 zfile_fseek (struct zfile *z, uae_s64 offset, int mode)
 {
 	if (z->zfileseek)
 		return z->zfileseek (z, offset, mode);
-	if (z->data || z->dataseek || (z->parent && z->useparent)) {
+	if (z->data || z->dataseek || (z->parent && z->useparent) || z->mapped) {
 		int ret = 0;
 		switch (mode)
 		{
@@ -2241,6 +2670,17 @@ size_t zfile_fread  (void *b, size_t l1, size_t l2, struct zfile *z)
 		z->seek = v + l1 * ret;
 		return ret;
 	}
+	if (z->mapped) {
+		if (z->seek + l1 * l2 > z->mappedsize) {
+			if (l1)
+				l2 = (z->mappedsize - z->seek) / l1;
+			else
+				l2 = 0;
+		}
+		memcpy (b, z->mapped + z->seek, l1 * l2);
+		z->seek += l1 * l2;
+		return l2;
+	}
 	return fread (b, l1, l2, z->f);
 }
 
@@ -2275,6 +2715,8 @@ size_t zfile_fwrite (const void *b, size_t l1, size_t l2, struct zfile *z)
 			z->datasize = z->size;
 		return l2;
 	}
+	if (z->mapped)
+		return 0;
 	return fwrite (b, l1, l2, z->f);
 }
 
@@ -2290,7 +2732,8 @@ size_t zfile_fputs (struct zfile *z, const TCHAR *s)
 char *zfile_fgetsa (char *s, int size, struct zfile *z)
 {
 	checkarchiveparent (z);
-	if (z->data) {
+	if (z->data || z->mapped) {
+		uae_u8 *data = z->data ? z->data : z->mapped;
 		char *os = s;
 		int i;
 		for (i = 0; i < size - 1; i++) {
@@ -2299,7 +2742,7 @@ char *zfile_fgetsa (char *s, int size, struct zfile *z)
 					return NULL;
 				break;
 			}
-			*s = z->data[z->seek++];
+			*s = data[z->seek++];
 			if (*s == '\n') {
 				s++;
 				break;
@@ -2316,7 +2759,8 @@ char *zfile_fgetsa (char *s, int size, struct zfile *z)
 TCHAR *zfile_fgets (TCHAR *s, int size, struct zfile *z)
 {
 	checkarchiveparent (z);
-	if (z->data) {
+	if (z->data || z->mapped) {
+		uae_u8 *data = z->data ? z->data : z->mapped;
 		char s2[MAX_DPATH];
 		char *p = s2;
 		int i;
@@ -2326,7 +2770,7 @@ TCHAR *zfile_fgets (TCHAR *s, int size, struct zfile *z)
 					return NULL;
 				break;
 			}
-			*p = z->data[z->seek++];
+			*p = data[z->seek++];
 			if (*p == 0 && i == 0)
 				return NULL;
 			if (*p == '\n' || *p == 0) {
@@ -2367,6 +2811,14 @@ int zfile_getc (struct zfile *z)
 		if (z->seek < z->size) {
 			out = z->data[z->seek++];
 		}
+	} else if (z->mapped) {
+		if (z->seek < z->mappedsize) {
+			out = z->mapped[z->seek++];
+		}
+	} else if (z->zfileread) {
+		uae_u8 b;
+		if (zfile_fread (&b, 1, 1, z) == 1)
+			out = b;
 	} else {
 		out = fgetc (z->f);
 	}
@@ -2378,10 +2830,34 @@ int zfile_ferror (struct zfile *z)
 	return 0;
 }
 
+/* Pointer straight into an in-memory or mapped zfile (or a sub-file view
+* of one), NULL if the range is not directly addressable.  */
+const uae_u8 *zfile_getdataptr (struct zfile *z, uae_s64 offset, uae_s64 len)
+{
+	if (offset < 0 || len < 0 || offset + len > z->size)
+		return NULL;
+	if (z->parent && z->useparent) {
+		offset += z->offset;
+		z = z->parent;
+	}
+	if (z->data && !z->archiveparent && z->offset + offset + len <= z->datasize)
+		return z->data + z->offset + offset;
+	if (z->mapped && offset + len <= z->mappedsize)
+		return z->mapped + offset;
+	return NULL;
+}
+
 uae_u8 *zfile_getdata (struct zfile *z, uae_s64 offset, int len)
 {
 	uae_s64 pos = zfile_ftell (z);
+	const uae_u8 *p;
 	uae_u8 *b;
+	if (len >= 0 && (p = zfile_getdataptr (z, offset, len))) {
+		b = xmalloc (uae_u8, len);
+		if (b)
+			memcpy (b, p, len);
+		return b;
+	}
 	if (len < 0) {
 		zfile_fseek (z, 0, SEEK_END);
 		len = zfile_ftell (z);
@@ -2477,11 +2953,13 @@ uae_u32 zfile_crc32 (struct zfile *f)
 	uae_u8 *p;
 	int pos, size;
 	uae_u32 crc;
+	const uae_u8 *data;
 
 	if (!f)
 		return 0;
-	if (f->data)
-		return get_crc32 (f->data, f->size);
+	data = zfile_getdataptr (f, 0, f->size);
+	if (data)
+		return get_crc32 ((void*)data, f->size);
 	pos = zfile_ftell (f);
 	zfile_fseek (f, 0, SEEK_END);
 	size = zfile_ftell (f);
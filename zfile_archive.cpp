@@ -407,6 +407,30 @@ struct zvolume *archive_directory_zip (struct zfile *z)
 }
 
 
+/* Large entries are not unpacked: stored ones become plain sub-file
+ * views of the archive, deflated ones are inflated on demand. Both are
+ * unpacked into memory after all if they are written to. */
+static struct zfile *archive_stream_zip (unzFile uz, struct znode *zn)
+{
+	unz_file_info file_info;
+	uLong pos;
+
+	if (unzGetCurrentFileInfo (uz, &file_info, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+		return NULL;
+	pos = unzGetCurrentFileZStreamPos (uz);
+	if (!pos || (file_info.flag & 1))
+		return NULL;
+	if (file_info.compression_method == 0) {
+		unpack_log (_T("ZIP: '%s' stored, using archive directly\n"), zn->fullname);
+		return zfile_fopen_stored (zn->volume->archive, zn->fullname, pos, zn->size);
+	}
+	if (file_info.compression_method == Z_DEFLATED) {
+		unpack_log (_T("ZIP: '%s' deflated, streaming\n"), zn->fullname);
+		return zfile_fopen_inflate (zn->volume->archive, zn->fullname, pos, file_info.compressed_size, zn->size);
+	}
+	return NULL;
+}
+
 static struct zfile *archive_do_zip (struct znode *zn, struct zfile *z, int flags)
 {
 	unzFile uz;
@@ -445,6 +469,14 @@ static struct zfile *archive_do_zip (struct znode *zn, struct zfile *z, int flag
 	s = NULL;
 	if (unzOpenCurrentFile (uz) != UNZ_OK)
 		goto error;
+	if (!z && zn->size >= ZSTREAM_MIN) {
+		z = archive_stream_zip (uz, zn);
+		if (z) {
+			unzCloseCurrentFile (uz);
+			unzClose (uz);
+			return z;
+		}
+	}
 	if (!z)
 		z = zfile_fopen_empty (NULL, zn->fullname, zn->size);
 	if (z) {